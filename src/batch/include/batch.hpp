@@ -0,0 +1,52 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Single independent run of one machine
+struct job
+{
+    std::filesystem::path m_rom;
+    std::filesystem::path m_boot_rom; // empty - boot is skipped
+    std::filesystem::path m_movie;    // empty - no input
+    std::filesystem::path m_state;    // empty - start from power on
+    uint64_t m_frames{600};
+
+    // outputs, written only when set
+    std::filesystem::path m_memory_output;
+    std::filesystem::path m_serial_output;
+    std::filesystem::path m_state_output;
+};
+
+struct job_result
+{
+    bool m_ok{};
+    std::string m_error;
+    uint64_t m_dots{};
+    uint64_t m_instructions{};
+    double m_seconds{};
+};
+
+// Command line of the batch runner
+struct batch_options
+{
+    std::filesystem::path m_job_list_file;
+    unsigned m_threads{}; // 0 - one per hardware thread
+    bool m_pin{};
+};
+
+// Throws on unknown options and invalid values, --threads is at least 1
+batch_options parse_options(int argc, char const *const argv[]);
+
+// Text file, one job per line as key=value pairs, '#' starts a comment
+// rom=<file> [frames=<n>] [boot_rom=<file>] [movie=<file>] [load_state=<file>]
+// [memory=<file>] [serial=<file>] [save_state=<file>]
+std::vector<job> load_jobs(std::filesystem::path const &job_list_file);
+
+// Never throws, failure is reported in result
+job_result run_job(job const &j);
+
+#endif
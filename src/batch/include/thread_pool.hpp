@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Each worker owns a queue, idle workers steal from the front of other queues
+class thread_pool
+{
+  public:
+    // 0 threads means one per hardware thread
+    // With pin_threads worker N is bound to the N-th allowed logical cpu, modulo their count ( Linux only )
+    // Throws when pinning fails
+    explicit thread_pool(unsigned threads = 0, bool pin_threads = false);
+    ~thread_pool();
+
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task is finished
+    void wait();
+
+    unsigned size() const;
+
+  private:
+    using task = std::function<void()>;
+
+    struct worker_queue
+    {
+        std::mutex m_mutex;
+        std::deque<task> m_tasks;
+    };
+
+    std::vector<std::unique_ptr<worker_queue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_work_cv;
+    std::condition_variable m_done_cv;
+
+    // waiting in queues, below 0 for a moment when a task is taken before submit counts it
+    std::atomic<std::ptrdiff_t> m_queued{};
+    std::atomic<size_t> m_running{}; // submitted and not finished
+    std::atomic<unsigned> m_next_queue{};
+    bool m_stop{};
+
+    void stop();
+    bool pop(unsigned self, task &t);
+    void work(unsigned self);
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include <batch.hpp>
+#include <command_line.hpp>
+#include <dmg.hpp>
+#include <movie.hpp>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace
+{
+
+job parse_job(std::string const &line, std::filesystem::path const &job_list_file, int line_number)
+{
+    auto error = [&](std::string const &what) {
+        std::stringstream ss;
+        ss << job_list_file.string() << ":" << line_number << ": " << what << "\n";
+        return std::runtime_error(ss.str());
+    };
+
+    job result;
+    std::istringstream iss{line};
+    std::string token;
+    while (iss >> token)
+    {
+        auto const eq = token.find('=');
+        if (eq == std::string::npos)
+            throw error("expected key=value, got [" + token + "]");
+
+        std::string const k = token.substr(0, eq);
+        std::string const v = token.substr(eq + 1);
+
+        if (k == "rom")
+            result.m_rom = v;
+        else if (k == "boot_rom")
+            result.m_boot_rom = v;
+        else if (k == "movie")
+            result.m_movie = v;
+        else if (k == "load_state")
+            result.m_state = v;
+        else if (k == "frames")
+        {
+            try
+            {
+                result.m_frames = to_number(k, v.c_str());
+            }
+            catch (std::exception const &)
+            {
+                throw error("invalid frames [" + v + "]");
+            }
+            if (result.m_frames == 0)
+                throw error("frames must be at least 1");
+        }
+        else if (k == "memory")
+            result.m_memory_output = v;
+        else if (k == "serial")
+            result.m_serial_output = v;
+        else if (k == "save_state")
+            result.m_state_output = v;
+        else
+            throw error("unknown key [" + k + "]");
+    }
+
+    if (result.m_rom.empty())
+        throw error("missing rom");
+
+    return result;
+}
+
+std::ofstream open_output(std::filesystem::path const &file)
+{
+    std::ofstream ofs{file, std::ios_base::out | std::ios_base::binary};
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open file: " + file.string() + "\n");
+    return ofs;
+}
+
+} // namespace
+
+batch_options parse_options(int argc, char const *const argv[])
+{
+    batch_options result;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view const arg{argv[i]};
+        if (arg == "--threads")
+        {
+            if (i + 1 >= argc)
+                throw std::runtime_error("Missing value for --threads\n");
+            uint64_t const threads = to_number(arg, argv[++i]);
+            if (threads < 1)
+                throw std::runtime_error("--threads must be at least 1\n");
+            if (threads > std::numeric_limits<unsigned>::max())
+                throw std::runtime_error("Invalid value for --threads: " + std::string{argv[i]} + "\n");
+            result.m_threads = static_cast<unsigned>(threads);
+        }
+        else if (arg == "--pin")
+            result.m_pin = true;
+        else if (arg.starts_with("--"))
+            throw std::runtime_error("Unknown option: " + std::string{arg} + "\n");
+        else
+            result.m_job_list_file = arg;
+    }
+
+    if (result.m_job_list_file.empty())
+        throw std::runtime_error("No job list given\n");
+
+    return result;
+}
+
+std::vector<job> load_jobs(std::filesystem::path const &job_list_file)
+{
+    std::ifstream ifs{job_list_file};
+    if (!ifs.is_open())
+        throw std::runtime_error("Cannot open file: " + job_list_file.string() + "\n");
+
+    std::vector<job> result;
+    std::string line;
+    int line_number{};
+    while (std::getline(ifs, line))
+    {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+        result.push_back(parse_job(line, job_list_file, line_number));
+    }
+    return result;
+}
+
+job_result run_job(job const &j)
+{
+    job_result result;
+    auto const start = std::chrono::steady_clock::now();
+    try
+    {
+        null_device screen;
+        boot_mode const mode = j.m_boot_rom.empty() ? boot_mode::SKIP : boot_mode::BOOT_ROM;
+        dmg gameboy{j.m_rom, screen, mode, j.m_boot_rom};
+        // nothing is shown, only the timing of ppu is needed
+        gameboy.set_renderer(renderer::SCANLINE);
+        gameboy.set_frame_skip(LOGIC_ONLY);
+
+        if (!j.m_state.empty())
+            gameboy.load_state(j.m_state);
+
+        movie const input{j.m_movie.empty() ? movie{} : load_movie(j.m_movie)};
+        play_movie(gameboy, input, j.m_frames);
+
+        if (!j.m_state_output.empty())
+            gameboy.save_state(j.m_state_output);
+
+        if (!j.m_memory_output.empty())
+        {
+            std::ofstream ofs{open_output(j.m_memory_output)};
+            for (uint32_t addr = 0; addr <= 0xFFFF; ++addr)
+                ofs.put(static_cast<char>(gameboy.peek(addr)));
+        }
+
+        if (!j.m_serial_output.empty())
+            open_output(j.m_serial_output) << gameboy.serial_output();
+
+        result.m_dots = gameboy.dots();
+        result.m_instructions = gameboy.instructions();
+        result.m_ok = true;
+    }
+    catch (std::exception const &e)
+    {
+        result.m_error = e.what();
+    }
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+    result.m_seconds = elapsed.count();
+    return result;
+}
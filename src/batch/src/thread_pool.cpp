@@ -0,0 +1,171 @@
+#include <thread_pool.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+
+// Logical cpus the process may run on, containers and taskset restrict them, empty where pinning is not supported
+std::vector<int> allowed_cpus()
+{
+    std::vector<int> result;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+        throw std::runtime_error(std::string{"Cannot read cpu affinity: "} + std::strerror(errno) + "\n");
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &set))
+            result.push_back(cpu);
+    }
+#endif
+    return result;
+}
+
+void pin_to_cpu(std::thread &t, int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int const error = pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+    if (error != 0)
+        throw std::runtime_error("Cannot pin worker to cpu " + std::to_string(cpu) + ": " + std::strerror(error) + "\n");
+#endif
+}
+
+} // namespace
+
+thread_pool::thread_pool(unsigned threads, bool pin_threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<int> const cpus = pin_threads ? allowed_cpus() : std::vector<int>{};
+
+    for (unsigned i = 0; i < threads; ++i)
+        m_queues.push_back(std::make_unique<worker_queue>());
+
+    try
+    {
+        for (unsigned i = 0; i < threads; ++i)
+        {
+            m_threads.emplace_back(&thread_pool::work, this, i);
+            if (!cpus.empty())
+                pin_to_cpu(m_threads.back(), cpus[i % cpus.size()]);
+        }
+    }
+    catch (...)
+    {
+        // started workers are joined, destructor does not run
+        stop();
+        throw;
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    wait();
+    stop();
+}
+
+void thread_pool::stop()
+{
+    {
+        std::lock_guard lock{m_mutex};
+        m_stop = true;
+    }
+    m_work_cv.notify_all();
+    for (auto &t : m_threads)
+        t.join();
+}
+
+void thread_pool::submit(std::function<void()> t)
+{
+    unsigned const idx = m_next_queue++ % m_queues.size();
+    ++m_running;
+    {
+        std::lock_guard lock{m_queues[idx]->m_mutex};
+        m_queues[idx]->m_tasks.push_back(std::move(t));
+    }
+    {
+        // counted after the push, so woken worker finds it
+        // under pool lock, so sleeping worker cannot miss it
+        std::lock_guard lock{m_mutex};
+        ++m_queued;
+    }
+    m_work_cv.notify_one();
+}
+
+void thread_pool::wait()
+{
+    std::unique_lock lock{m_mutex};
+    m_done_cv.wait(lock, [this]() { return m_running == 0; });
+}
+
+unsigned thread_pool::size() const
+{
+    return static_cast<unsigned>(m_threads.size());
+}
+
+bool thread_pool::pop(unsigned self, task &t)
+{
+    // own queue from the back, newest task has the warmest cache
+    {
+        worker_queue &own = *m_queues[self];
+        std::lock_guard lock{own.m_mutex};
+        if (!own.m_tasks.empty())
+        {
+            t = std::move(own.m_tasks.back());
+            own.m_tasks.pop_back();
+            return true;
+        }
+    }
+
+    // steal the oldest task of other workers
+    for (size_t i = 1; i < m_queues.size(); ++i)
+    {
+        worker_queue &victim = *m_queues[(self + i) % m_queues.size()];
+        std::lock_guard lock{victim.m_mutex};
+        if (!victim.m_tasks.empty())
+        {
+            t = std::move(victim.m_tasks.front());
+            victim.m_tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void thread_pool::work(unsigned self)
+{
+    while (true)
+    {
+        task t;
+        if (pop(self, t))
+        {
+            --m_queued;
+            t();
+            if (--m_running == 0)
+            {
+                std::lock_guard lock{m_mutex};
+                m_done_cv.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock lock{m_mutex};
+        m_work_cv.wait(lock, [this]() { return m_stop || m_queued > 0; });
+        if (m_stop && m_queued <= 0)
+            return;
+    }
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <batch.hpp>
+#include <thread_pool.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <set>
+
+namespace
+{
+
+std::filesystem::path const resources{RESOURCES_DIR};
+
+std::vector<char> read_all(std::filesystem::path const &file)
+{
+    std::ifstream ifs{file, std::ios_base::binary};
+    return {std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+}
+
+} // namespace
+
+TEST(thread_pool_tests, runs_all_tasks)
+{
+    std::atomic<int> counter{};
+    thread_pool pool{4};
+    for (int i = 0; i < 1000; ++i)
+        pool.submit([&counter]() { ++counter; });
+    pool.wait();
+    ASSERT_EQ(counter, 1000);
+
+    // pool can be reused after wait
+    for (int i = 0; i < 10; ++i)
+        pool.submit([&counter]() { ++counter; });
+    pool.wait();
+    ASSERT_EQ(counter, 1010);
+}
+
+TEST(thread_pool_tests, pinned_workers_can_outnumber_cpus)
+{
+    std::atomic<int> counter{};
+    thread_pool pool{std::thread::hardware_concurrency() * 2 + 1, true};
+    for (int i = 0; i < 100; ++i)
+        pool.submit([&counter]() { ++counter; });
+    pool.wait();
+    ASSERT_EQ(counter, 100);
+}
+
+TEST(thread_pool_tests, idle_workers_steal)
+{
+    std::mutex m;
+    std::set<std::thread::id> ids;
+    thread_pool pool{4};
+    for (int i = 0; i < 64; ++i)
+    {
+        pool.submit([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            std::lock_guard lock{m};
+            ids.insert(std::this_thread::get_id());
+        });
+    }
+    pool.wait();
+    ASSERT_GT(ids.size(), 1u);
+}
+
+TEST(batch_tests, parallel_runs_are_deterministic)
+{
+    auto const dir = std::filesystem::temp_directory_path();
+
+    std::vector<job> jobs(4);
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        jobs[i].m_rom = resources / "01.gb";
+        jobs[i].m_frames = 30;
+        jobs[i].m_memory_output = dir / ("batch_test_" + std::to_string(i) + ".bin");
+    }
+
+    std::vector<job_result> results(jobs.size());
+    thread_pool pool{4};
+    for (size_t i = 0; i < jobs.size(); ++i)
+        pool.submit([&, i]() { results[i] = run_job(jobs[i]); });
+    pool.wait();
+
+    job_result const single = run_job(jobs[0]);
+    ASSERT_TRUE(single.m_ok) << single.m_error;
+    auto const expected = read_all(jobs[0].m_memory_output);
+    ASSERT_EQ(expected.size(), 0x10000u);
+
+    for (size_t i = 1; i < jobs.size(); ++i)
+    {
+        ASSERT_TRUE(results[i].m_ok) << results[i].m_error;
+        ASSERT_EQ(results[i].m_instructions, single.m_instructions);
+        ASSERT_EQ(read_all(jobs[i].m_memory_output), expected);
+    }
+}
+
+TEST(batch_tests, missing_rom_is_reported)
+{
+    job j;
+    j.m_rom = resources / "no_such_rom.gb";
+    job_result const r = run_job(j);
+    ASSERT_FALSE(r.m_ok);
+    ASSERT_FALSE(r.m_error.empty());
+}
+
+TEST(batch_tests, threads_option_is_checked)
+{
+    auto parse = [](char const *threads) {
+        char const *const argv[]{"RM_GB_Emu_Batch", "jobs.txt", "--threads", threads};
+        return parse_options(4, argv);
+    };
+
+    batch_options const opt = parse("4");
+    ASSERT_EQ(opt.m_threads, 4u);
+    ASSERT_EQ(opt.m_job_list_file, "jobs.txt");
+
+    for (char const *bad : {"0", "-1", "abc", "4x", "", " 4", "+4", "99999999999999999999"})
+        ASSERT_THROW(parse(bad), std::runtime_error) << "[" << bad << "]";
+
+    char const *const missing[]{"RM_GB_Emu_Batch", "jobs.txt", "--threads"};
+    ASSERT_THROW(parse_options(3, missing), std::runtime_error);
+}
+
+TEST(batch_tests, invalid_frames_are_rejected)
+{
+    auto const file = std::filesystem::temp_directory_path() / "batch_test_jobs.txt";
+    for (char const *bad : {"-5", "12abc", "0", "", "99999999999999999999"})
+    {
+        std::ofstream{file} << "rom=01.gb frames=" << bad << "\n";
+        ASSERT_THROW(load_jobs(file), std::runtime_error) << "[" << bad << "]";
+    }
+
+    std::ofstream{file} << "rom=01.gb frames=12\n";
+    auto const jobs = load_jobs(file);
+    ASSERT_EQ(jobs.size(), 1u);
+    ASSERT_EQ(jobs[0].m_frames, 12u);
+    std::filesystem::remove(file);
+}
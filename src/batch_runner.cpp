@@ -0,0 +1,99 @@
+#include <batch.hpp>
+#include <dmg.hpp>
+#include <thread_pool.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+
+void usage()
+{
+    std::cout << "Usage: RM_GB_Emu_Batch <job-list> [options]\n"
+                 "  --threads <n>  worker threads, default one per hardware thread\n"
+                 "  --pin          bind each worker to its own logical cpu\n"
+                 "Job list: one job per line\n"
+                 "  rom=<file> [frames=<n>] [boot_rom=<file>] [movie=<file>] [load_state=<file>]\n"
+                 "  [memory=<file>] [serial=<file>] [save_state=<file>]\n";
+}
+
+void report(std::vector<job> const &jobs, std::vector<job_result> const &results, unsigned threads, double seconds)
+{
+    uint64_t total_dots{}, total_instructions{};
+    double cpu_seconds{};
+    size_t failed{};
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        job_result const &r = results[i];
+        std::cout << "#" << i << " " << jobs[i].m_rom.string() << ": ";
+        if (!r.m_ok)
+        {
+            ++failed;
+            std::cout << "FAILED " << r.m_error;
+            continue;
+        }
+        total_dots += r.m_dots;
+        total_instructions += r.m_instructions;
+        cpu_seconds += r.m_seconds;
+        std::cout << "ok, " << r.m_dots / DOTS_PER_FRAME << " frames, " << r.m_instructions << " instructions, " << r.m_seconds << " s\n";
+    }
+
+    double const frames = static_cast<double>(total_dots) / DOTS_PER_FRAME;
+    std::cout << "jobs:           " << jobs.size() << " ( " << failed << " failed )\n";
+    std::cout << "threads:        " << threads << '\n';
+    std::cout << "wall time:      " << seconds << " s\n";
+    std::cout << "frames/s:       " << frames / seconds << '\n';
+    std::cout << "instructions/s: " << total_instructions / seconds << '\n';
+    std::cout << "speed:          " << static_cast<double>(total_dots) / DOTS_PER_SECOND / seconds << "x real time\n";
+    std::cout << "scaling:        " << cpu_seconds / seconds << "x of single thread\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    batch_options opt;
+    std::vector<job> jobs;
+    try
+    {
+        opt = parse_options(argc, argv);
+        jobs = load_jobs(opt.m_job_list_file);
+    }
+    catch (std::exception const &e)
+    {
+        std::cerr << e.what();
+        usage();
+        return 1;
+    }
+
+    std::unique_ptr<thread_pool> pool_ptr;
+    try
+    {
+        pool_ptr = std::make_unique<thread_pool>(opt.m_threads, opt.m_pin);
+    }
+    catch (std::exception const &e)
+    {
+        std::cerr << e.what();
+        return 1;
+    }
+    thread_pool &pool = *pool_ptr;
+
+    std::vector<job_result> results(jobs.size());
+    auto const start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < jobs.size(); ++i)
+        pool.submit([&jobs, &results, i]() { results[i] = run_job(jobs[i]); });
+    pool.wait();
+
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+    report(jobs, results, pool.size(), elapsed.count());
+
+    // scripts see failed jobs from the exit code
+    bool const failed = std::any_of(results.begin(), results.end(), [](job_result const &r) { return !r.m_ok; });
+    return failed ? 2 : 0;
+}
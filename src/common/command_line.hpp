@@ -0,0 +1,25 @@
+#ifndef COMMAND_LINE_HPP
+#define COMMAND_LINE_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Value of numeric option, digits only, strtoull alone would take signs, spaces and overflow
+// Values above max are rejected, so the caller can cast to a smaller type
+inline uint64_t to_number(std::string_view option, char const *value,
+                          uint64_t max = std::numeric_limits<uint64_t>::max())
+{
+    char *end{};
+    errno = 0;
+    uint64_t const result = std::strtoull(value, &end, 10);
+    if (*value < '0' || *value > '9' || *end != '\0' || errno == ERANGE || result > max)
+        throw std::runtime_error("Invalid value for " + std::string{option} + ": " + value + "\n");
+    return result;
+}
+
+#endif
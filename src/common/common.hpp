@@ -1,7 +1,10 @@
 #ifndef COMMON_HPP
 #define COMMON_HPP
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 
 #define checkbit(byte, nbit) ((byte) & (1 << (nbit)))
 #define setbit(byte, nbit) ((byte) |= (1 << (nbit)))
@@ -24,6 +27,24 @@ struct rw_device
     virtual void write(uint16_t addr, uint8_t data, device d = device::CPU, bool direct = false) = 0;
 };
 
+enum class key
+{
+    UP,
+    DOWN,
+    LEFT,
+    RIGHT,
+    START,
+    SELECT,
+    A,
+    B
+};
+
+enum class key_action
+{
+    up,
+    down
+};
+
 struct screen_coordinates
 {
     uint8_t m_x{};
@@ -37,6 +58,8 @@ struct sprite
     uint8_t m_tile_index{};
     uint8_t m_flags{};
 
+    bool operator==(sprite const &) const = default;
+
     uint8_t priority() const
     {
         return checkbit(m_flags, 7) ? 1 : 0;
@@ -47,22 +70,80 @@ struct sprite
         return checkbit(m_flags, 4) ? 1 : 0;
     }
 
-    uint16_t line_addr(uint8_t line) const
+    bool x_flip() const
     {
-        return 0x8000 + (m_tile_index * 16) + (line * 2);
+        return checkbit(m_flags, 5);
+    }
+
+    bool y_flip() const
+    {
+        return checkbit(m_flags, 6);
+    }
+
+    // line - counted from the top of sprite on screen, height - 8 or 16
+    // 8x16 sprite is tile pair starting at even index, Y flip swaps them too
+    uint16_t line_addr(uint8_t line, uint8_t height) const
+    {
+        uint8_t const tile = height == 16 ? (m_tile_index & 0xFE) : m_tile_index;
+        uint8_t const row = y_flip() ? height - 1 - line : line;
+        return 0x8000 + (tile * 16) + (row * 2);
     }
 };
 
-struct color
+// Packed RGBA32, red in the lowest byte, so in memory it is R, G, B, A
+using color = uint32_t;
+
+constexpr color make_color(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 0xFF)
 {
-    float R{}, G{}, B{};
-};
+    return static_cast<color>(r) | static_cast<color>(g) << 8 | static_cast<color>(b) << 16 | static_cast<color>(a) << 24;
+}
+
+constexpr uint8_t color_red(color c)
+{
+    return static_cast<uint8_t>(c);
+}
 
+constexpr uint8_t color_green(color c)
+{
+    return static_cast<uint8_t>(c >> 8);
+}
+
+constexpr uint8_t color_blue(color c)
+{
+    return static_cast<uint8_t>(c >> 16);
+}
+
+// Colors of the four shades, from the lightest, palettes pick them by value 0-3
+constexpr std::array<color, 4> SCREEN_SHADES{make_color(255, 255, 255), make_color(221, 180, 181), make_color(97, 79, 77),
+                                             make_color(0, 0, 0)};
+
+constexpr size_t SCREEN_WIDTH{160};
+constexpr size_t SCREEN_HEIGHT{144};
+
+// Rows of SCREEN_WIDTH pixels, top row first
+using frame_buffer = std::span<color, SCREEN_WIDTH * SCREEN_HEIGHT>;
+using frame_view = std::span<color const, SCREEN_WIDTH * SCREEN_HEIGHT>;
+using line_view = std::span<color const, SCREEN_WIDTH>;
+
+// Views are valid until the PPU starts drawing the next line
 struct drawing_device
 {
     virtual ~drawing_device() = default;
-    virtual void after_frame() = 0;
-    virtual void push_pixel(color c) = 0;
+
+    // Line of the frame is complete, y and pixels of the line are given
+    virtual void after_line(uint8_t, line_view)
+    {
+    }
+
+    virtual void after_frame(frame_view frame) = 0;
+};
+
+// Drops every frame, for machines which are run without a screen
+struct null_device : public drawing_device
+{
+    void after_frame(frame_view) override
+    {
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Bounded ring for one producer and one consumer thread, no locks
+// Producer waits while it is full, consumer while it is empty, both sleep on the index of the other side
+// Large items are written and read in place: claim or try_claim gives the free slot, commit publishes it,
+// front gives the oldest item, release frees its slot. push and pop move whole items.
+// Committing does not wake the consumer, producer does it when enough items are there, waking is a system call
+template <typename T, size_t Capacity> class spsc_queue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity is power of two");
+
+  public:
+    // Producer, waits for a free slot
+    T &claim()
+    {
+        size_t const tail = m_tail.load(std::memory_order_relaxed);
+        for (size_t head = m_head.load(std::memory_order_acquire); tail - head == Capacity;
+             head = m_head.load(std::memory_order_acquire))
+            m_head.wait(head, std::memory_order_acquire);
+        return m_items[tail & (Capacity - 1)];
+    }
+
+    // Producer, never waits, nullptr when the ring is full
+    T *try_claim()
+    {
+        size_t const tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            return nullptr;
+        return &m_items[tail & (Capacity - 1)];
+    }
+
+    // Producer, claimed slot becomes visible to the consumer
+    void commit()
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void push(T value)
+    {
+        claim() = std::move(value);
+        commit();
+    }
+
+    void wake_consumer()
+    {
+        m_tail.notify_one();
+    }
+
+    // Consumer, waits for an item, it stays in the ring until release
+    T &front()
+    {
+        size_t const head = m_head.load(std::memory_order_relaxed);
+        for (size_t tail = m_tail.load(std::memory_order_acquire); tail == head;
+             tail = m_tail.load(std::memory_order_acquire))
+            m_tail.wait(tail, std::memory_order_acquire);
+        return m_items[head & (Capacity - 1)];
+    }
+
+    // Consumer, slot of the front item is given back to the producer
+    void release()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        m_head.notify_one();
+    }
+
+    // Item is moved out, so the slot does not keep its resources
+    T pop()
+    {
+        T value{std::move(front())};
+        release();
+        return value;
+    }
+
+  private:
+    std::array<T, Capacity> m_items{};
+
+    // ever growing, written by one side each, on own cache lines
+    alignas(64) std::atomic<size_t> m_head{};
+    alignas(64) std::atomic<size_t> m_tail{};
+};
+
+#endif
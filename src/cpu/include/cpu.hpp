@@ -10,6 +10,35 @@
 struct registers;
 struct opcode;
 
+// Plain data, save states copy it as a whole
+struct cpu_state
+{
+    registers m_reg;
+    uint8_t m_T_states{1};
+    bool m_is_stopped{};
+    bool m_is_halted{};
+
+    uint8_t m_interrupt_wait{};
+
+    enum class IME
+    {
+        ENABLED,
+        WANT_ENABLE,
+        ENABLING_IN_PROGRESS,
+        DISABLED
+    };
+    IME m_IME{IME::DISABLED};
+
+    // timer
+    int m_div_cc{52};
+    int m_tima_cc{1024};
+    int m_tima_freq{};
+    int m_overflow_value{};
+
+    // serial transfer
+    int m_serial_transfer_cc{128 * 4};
+};
+
 class cpu
 {
     using cb = std::function<void(registers const &, opcode const &op)>;
@@ -24,6 +53,9 @@ class cpu
 
     void resume(); // to resume after STOP opcode
 
+    cpu_state save_state() const;
+    void load_state(cpu_state const &state);
+
     struct cpu_impl;
 
   private:
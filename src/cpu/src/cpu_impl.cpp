@@ -125,24 +125,23 @@ void cpu::cpu_impl::push_PC()
 void cpu::cpu_impl::serial_transfer()
 {
     constexpr int M128{128 * 4};
-    static int serial_transfer_cc{M128};
 
     uint8_t const SC = m_rw_device.read(0xFF02);
     if (checkbit(SC, 7))
     {
         if (checkbit(SC, 0))
         {
-            --serial_transfer_cc;
-            if (!serial_transfer_cc)
+            --m_serial_transfer_cc;
+            if (!m_serial_transfer_cc)
             {
                 m_rw_device.write(0xFF02, (SC & 0x7F));
                 SERIAL_INT();
-                serial_transfer_cc = M128;
+                m_serial_transfer_cc = M128;
             }
         }
     }
     else
-        serial_transfer_cc = M128;
+        m_serial_transfer_cc = M128;
 }
 
 void cpu::cpu_impl::tick()
@@ -298,3 +297,13 @@ void cpu::resume()
 {
     m_pimpl->resume();
 }
+
+cpu_state cpu::save_state() const
+{
+    return *m_pimpl;
+}
+
+void cpu::load_state(cpu_state const &state)
+{
+    static_cast<cpu_state &>(*m_pimpl) = state;
+}
@@ -8,30 +8,17 @@
 #include <sstream>
 #include <stdexcept>
 
-struct cpu::cpu_impl
+// Registers, IME and counters come from cpu_state
+struct cpu::cpu_impl : public cpu_state
 {
 
     cpu_impl(rw_device &rw_device, cb callback = nullptr);
     ~cpu_impl() = default;
 
-    registers m_reg;
     rw_device &m_rw_device;
     opcode m_op;
     cb m_callback;
-    uint8_t m_T_states{1};
-    bool m_is_stopped{};
-    bool m_is_halted{};
-
-    uint8_t m_interrupt_wait{};
-
-    enum class IME
-    {
-        ENABLED,
-        WANT_ENABLE,
-        ENABLING_IN_PROGRESS,
-        DISABLED
-    };
-    IME m_IME{IME::DISABLED};
+
     void adjust_ime();
 
     bool is_int_pending();
@@ -4,7 +4,6 @@
 
 namespace
 {
-cpu::cpu_impl *g_cpu{};
 
 constexpr uint16_t IF_ADDR{0xFF0F};
 
@@ -25,23 +24,21 @@ constexpr uint8_t JOYPAD_JUMP_ADDR{0x60};
 
 using im = cpu::cpu_impl::IME;
 
-void int_handler(uint8_t bit_to_clear, uint16_t addr_to_jump)
+void int_handler(cpu::cpu_impl &cpu, uint8_t bit_to_clear, uint16_t addr_to_jump)
 {
-    g_cpu->m_IME = im::DISABLED;
-    uint8_t IF = g_cpu->m_rw_device.read(0xFF0F);
+    cpu.m_IME = im::DISABLED;
+    uint8_t IF = cpu.m_rw_device.read(0xFF0F);
     clearbit(IF, bit_to_clear);
-    g_cpu->m_rw_device.write(IF_ADDR, IF);
-    g_cpu->push_PC();
-    g_cpu->m_reg.PC() = addr_to_jump;
-    g_cpu->m_interrupt_wait = 20;
+    cpu.m_rw_device.write(IF_ADDR, IF);
+    cpu.push_PC();
+    cpu.m_reg.PC() = addr_to_jump;
+    cpu.m_interrupt_wait = 20;
 }
 
 } // namespace
 
 void check_interrupt(cpu::cpu_impl &cpu)
 {
-    g_cpu = &cpu;
-
     uint8_t IE = cpu.m_rw_device.read(0xFFFF);
     uint8_t IF = cpu.m_rw_device.read(0xFF0F);
 
@@ -50,22 +47,22 @@ void check_interrupt(cpu::cpu_impl &cpu)
 
     if (checkbit(IF & IE, VBLANK_BIT))
     {
-        int_handler(VBLANK_BIT, VBLANK_JUMP_ADDR);
+        int_handler(cpu, VBLANK_BIT, VBLANK_JUMP_ADDR);
     }
     else if (checkbit(IF & IE, STAT_BIT))
     {
-        int_handler(STAT_BIT, STAT_JUMP_ADDR);
+        int_handler(cpu, STAT_BIT, STAT_JUMP_ADDR);
     }
     else if (checkbit(IF & IE, TIMER_BIT))
     {
-        int_handler(TIMER_BIT, TIMER_JUMP_ADDR);
+        int_handler(cpu, TIMER_BIT, TIMER_JUMP_ADDR);
     }
     else if (checkbit(IF & IE, SERIAL_BIT))
     {
-        int_handler(SERIAL_BIT, SERIAL_JUMP_ADDR);
+        int_handler(cpu, SERIAL_BIT, SERIAL_JUMP_ADDR);
     }
     else if (checkbit(IF & IE, JOYPAD_BIT))
     {
-        int_handler(JOYPAD_BIT, JOYPAD_JUMP_ADDR);
+        int_handler(cpu, JOYPAD_BIT, JOYPAD_JUMP_ADDR);
     }
 }
@@ -8,13 +8,6 @@ constexpr int MC16{64};    // 65536 Hz
 constexpr int MC64{256};   // 16384 Hz
 constexpr int MC256{1024}; // 4096 Hz
 
-int DIV_CC{52};
-
-int TIMA_CC{MC256};
-int tima_freq{0};
-
-int overflow_value{0};
-
 } // namespace lol
 
 using namespace lol;
@@ -22,25 +15,25 @@ using namespace lol;
 // It is called on each cpu tick
 void cpu::cpu_impl::timer()
 {
-    --DIV_CC;
-    if (!DIV_CC)
+    --m_div_cc;
+    if (!m_div_cc)
     {
         uint8_t div_timer_value = m_rw_device.read(0xFF04);
         m_rw_device.write(0xFF04, ++div_timer_value, device::CPU, true);
-        DIV_CC = MC64;
+        m_div_cc = MC64;
     }
 
-    if (overflow_value >= 1)
+    if (m_overflow_value >= 1)
     {
-        ++overflow_value;
+        ++m_overflow_value;
 
-        if (overflow_value == 5)
+        if (m_overflow_value == 5)
         {
             uint8_t const timer_modulo = m_rw_device.read(0xFF06);
             m_rw_device.write(0xFF05, timer_modulo, device::CPU, true);
 
             TIMER_INT();
-            overflow_value = 0;
+            m_overflow_value = 0;
             return;
         }
     }
@@ -50,37 +43,37 @@ void cpu::cpu_impl::timer()
     {
         uint8_t const clock_selection = TAC & 0x03;
 
-        uint8_t old_freq = tima_freq;
+        uint8_t old_freq = m_tima_freq;
 
         switch (clock_selection)
         {
         case 0x00:
-            tima_freq = MC256;
+            m_tima_freq = MC256;
             break;
         case 0x01:
-            tima_freq = MC4;
+            m_tima_freq = MC4;
             break;
         case 0x10:
-            tima_freq = MC16;
+            m_tima_freq = MC16;
             break;
         case 0x11:
-            tima_freq = MC64;
+            m_tima_freq = MC64;
             break;
         }
 
-        if (old_freq != tima_freq)
-            TIMA_CC = tima_freq;
+        if (old_freq != m_tima_freq)
+            m_tima_cc = m_tima_freq;
 
-        --TIMA_CC;
-        if (!TIMA_CC)
+        --m_tima_cc;
+        if (!m_tima_cc)
         {
             uint8_t const tima_counter_value = m_rw_device.read(0xFF05);
 
             m_rw_device.write(0xFF05, tima_counter_value + 1, device::CPU, true);
-            TIMA_CC = tima_freq;
+            m_tima_cc = m_tima_freq;
 
             if (tima_counter_value == 0xFF) // previous increment == overflow + INT
-                overflow_value = 1;
+                m_overflow_value = 1;
         }
     }
 }
\ No newline at end of file
@@ -270,18 +270,19 @@ bool cache_opcodes()
 
 bool load_opcodes() noexcept
 {
-    if (OPCODES_CACHE[0].m_mnemonic != nullptr)
-        return true;
-
-    try
-    {
-        return cache_opcodes();
-    }
-    catch (const std::exception &e)
-    {
-        std::cerr << e.what() << '\n';
-        return false;
-    }
+    // Initialized once, also when many cpus are created from different threads
+    static bool const loaded = []() noexcept {
+        try
+        {
+            return cache_opcodes();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << '\n';
+            return false;
+        }
+    }();
+    return loaded;
 }
 
 opcode &get_opcode(uint8_t opcode_hex, bool pref_opcode) noexcept
@@ -0,0 +1,93 @@
+#ifndef DMG_HPP
+#define DMG_HPP
+
+#include <common.hpp>
+#include <ppu.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+// 1 dot == 1 T-cycle, 4194304 dots per second
+constexpr uint32_t DOTS_PER_SECOND{4194304};
+constexpr uint32_t DOTS_PER_FRAME{70224};
+
+enum class boot_mode
+{
+    BOOT_ROM, // start at 0x0000 with boot rom mapped
+    SKIP      // start at 0x0100 with registers set as after boot rom
+};
+
+class dmg
+{
+  public:
+    // Boot rom file is used only with boot_mode::BOOT_ROM
+    dmg(std::filesystem::path const &rom_file, drawing_device &drawing_device, boot_mode mode = boot_mode::BOOT_ROM,
+        std::filesystem::path const &boot_rom_file = {});
+    dmg(dmg &&other) noexcept;
+    dmg &operator=(dmg &&other) noexcept;
+    ~dmg();
+
+    // Independent copy of the machine, memory pages are shared copy-on-write
+    // Child draws to the same device unless other one is given
+    dmg fork() const;
+    dmg fork(drawing_device &drawing_device) const;
+
+    // Single PPU dot, CPU is ticked inside
+    void dot();
+    void run_dots(uint64_t dots);
+
+    // Frame is measured in dots, so it also works when LCD is off
+    void run_frame();
+
+    // Run-ahead: emulates one frame without showing it, then shows the frame
+    // which is given number of frames ahead, using current input. Machine itself
+    // advances only one frame, so input lag built into the game is hidden
+    void run_frame_ahead(uint32_t frames);
+
+    // Disabled output skips drawing device calls, emulation is not affected
+    void set_video_output(bool enabled);
+
+    // Pixels are drawn straight into given buffer instead of the machine's own one
+    // Buffer has to outlive the machine, frames shown by run-ahead are drawn into it too, forks use their own buffer
+    void set_frame_buffer(frame_buffer buffer);
+
+    // All renderers give the same frames, FIFO is the default, forks of THREADED one use SCANLINE
+    void set_renderer(renderer r);
+
+    // Frames skipped after every drawn one, LOGIC_ONLY never draws, timing is not affected
+    void set_frame_skip(uint32_t frames);
+
+    void key_event(key_action a, key k);
+
+    // Read without side effects, e.g. to dump memory after run
+    uint8_t peek(uint16_t addr) const;
+
+    uint64_t dots() const;
+    uint64_t instructions() const;
+
+    // Bytes sent by the game through serial port ( 0xFF01 / 0xFF02 )
+    std::string const &serial_output() const;
+
+    // Whole machine as versioned binary blob, buffer capacity is reused
+    void save_state(std::vector<uint8_t> &out) const;
+    std::vector<uint8_t> save_state() const;
+
+    // Throws std::runtime_error when state was saved by other version or build
+    void load_state(std::span<uint8_t const> state);
+
+    // Same through a file
+    void save_state(std::filesystem::path const &state_file) const;
+    void load_state(std::filesystem::path const &state_file);
+
+    struct dmg_impl;
+
+  private:
+    explicit dmg(std::unique_ptr<dmg_impl> impl);
+
+    std::unique_ptr<dmg_impl> m_pimpl;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef MOVIE_HPP
+#define MOVIE_HPP
+
+#include <common.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+class dmg;
+
+struct input_event
+{
+    uint64_t m_frame{}; // applied before this frame is emulated
+    key m_key{};
+    key_action m_action{};
+};
+
+using movie = std::vector<input_event>;
+
+// Text file, one event per line: <frame> <key> <down|up>
+// Keys: UP DOWN LEFT RIGHT START SELECT A B, '#' starts a comment
+movie load_movie(std::filesystem::path const &movie_file);
+
+// Emulates frames, events of each frame are applied before it starts
+// With run_ahead each shown frame is that many frames ahead, see dmg::run_frame_ahead
+void play_movie(dmg &gameboy, movie const &m, uint64_t frames, uint32_t run_ahead = 0);
+
+#endif
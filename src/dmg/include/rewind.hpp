@@ -0,0 +1,75 @@
+#ifndef REWIND_HPP
+#define REWIND_HPP
+
+#include <common.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class dmg;
+
+// Drives machine frame by frame and keeps its history
+// Every snapshot is stored as delta against the keyframe that starts its group
+class rewind_buffer
+{
+  public:
+    // snapshot_interval - frames between snapshots
+    // keyframe_interval - snapshots between keyframes
+    // capacity - bytes of history, oldest group is dropped when it is exceeded
+    explicit rewind_buffer(dmg &gameboy, uint32_t snapshot_interval = 1, uint32_t keyframe_interval = 60,
+                           size_t capacity = 64 * 1024 * 1024);
+
+    // Input is applied at the start of the next frame and recorded for re-simulation
+    void key_event(key_action a, key k);
+
+    void run_frame();
+
+    // Machine goes back to the start of previous frame, false when there is no more history
+    bool step_back();
+
+    // Frames run since creation, minus frames stepped back
+    uint64_t frame() const;
+
+    uint64_t oldest_frame() const;
+    size_t memory_used() const;
+
+  private:
+    struct group
+    {
+        uint64_t m_first_frame{};
+        std::vector<uint8_t> m_keyframe;
+        std::vector<uint8_t> m_deltas;
+        std::vector<size_t> m_delta_offsets; // delta i spans [offsets[i], offsets[i + 1])
+        size_t snapshots() const;
+        size_t bytes() const;
+    };
+
+    struct recorded_input
+    {
+        uint64_t m_frame{};
+        key_action m_action{};
+        key m_key{};
+    };
+
+    dmg &m_gameboy;
+    uint32_t const m_snapshot_interval;
+    uint32_t const m_keyframe_interval;
+    size_t const m_capacity;
+
+    uint64_t m_frame{};
+    std::deque<group> m_groups;
+    std::deque<recorded_input> m_inputs;
+    std::vector<recorded_input> m_pending_inputs;
+    size_t m_memory_used{};
+
+    // reused between frames, no allocation in steady state
+    std::vector<uint8_t> m_state;
+
+    void take_snapshot();
+    void restore(group const &g, size_t snapshot);
+    void truncate_after(uint64_t frame);
+    void apply_inputs(uint64_t frame);
+};
+
+#endif
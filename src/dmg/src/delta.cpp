@@ -0,0 +1,129 @@
+#include "delta.hpp"
+#include <cassert>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DELTA_SSE2
+#endif
+
+namespace
+{
+
+// Different bytes are not split by shorter equal runs, pair header would cost more
+constexpr size_t MIN_EQUAL_RUN{8};
+
+void put_varint(std::vector<uint8_t> &out, size_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+size_t get_varint(uint8_t const *&pos)
+{
+    size_t result{};
+    int shift{};
+    while (*pos & 0x80)
+    {
+        result |= static_cast<size_t>(*pos++ & 0x7F) << shift;
+        shift += 7;
+    }
+    result |= static_cast<size_t>(*pos++) << shift;
+    return result;
+}
+
+int count_trailing_zeros(uint32_t value)
+{
+    int result{};
+    while (!(value & 1))
+    {
+        value >>= 1;
+        ++result;
+    }
+    return result;
+}
+
+} // namespace
+
+size_t equal_bytes(uint8_t const *l, uint8_t const *r, size_t size)
+{
+    size_t i{};
+#ifdef DELTA_SSE2
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i const a = _mm_loadu_si128(reinterpret_cast<__m128i const *>(l + i));
+        __m128i const b = _mm_loadu_si128(reinterpret_cast<__m128i const *>(r + i));
+        uint32_t const mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+        if (mask != 0xFFFF)
+            return i + count_trailing_zeros(~mask);
+    }
+#else
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t a, b;
+        std::memcpy(&a, l + i, 8);
+        std::memcpy(&b, r + i, 8);
+        if (a != b)
+            break;
+    }
+#endif
+    while (i < size && l[i] == r[i])
+        ++i;
+    return i;
+}
+
+void encode_delta(std::span<uint8_t const> keyframe, std::span<uint8_t const> state, std::vector<uint8_t> &out)
+{
+    assert(keyframe.size() == state.size());
+    size_t const size = state.size();
+    size_t pos{};
+    while (pos < size)
+    {
+        size_t const equal = equal_bytes(keyframe.data() + pos, state.data() + pos, size - pos);
+        size_t const diff_begin = pos + equal;
+        if (diff_begin == size)
+            break;
+
+        // extend different run until long enough equal run is found
+        size_t diff_end = diff_begin;
+        while (diff_end < size)
+        {
+            if (keyframe[diff_end] != state[diff_end])
+            {
+                ++diff_end;
+                continue;
+            }
+            size_t const run = equal_bytes(keyframe.data() + diff_end, state.data() + diff_end, size - diff_end);
+            if (run >= MIN_EQUAL_RUN || diff_end + run == size)
+                break;
+            diff_end += run;
+        }
+
+        put_varint(out, equal);
+        put_varint(out, diff_end - diff_begin);
+        for (size_t i = diff_begin; i < diff_end; ++i)
+            out.push_back(keyframe[i] ^ state[i]);
+        pos = diff_end;
+    }
+}
+
+void apply_delta(std::span<uint8_t const> delta, std::span<uint8_t> state)
+{
+    uint8_t const *in = delta.data();
+    uint8_t const *const end = in + delta.size();
+    size_t pos{};
+    while (in < end)
+    {
+        pos += get_varint(in);
+        size_t const count = get_varint(in);
+        assert(pos + count <= state.size());
+        for (size_t i = 0; i < count; ++i)
+            state[pos + i] ^= in[i];
+        in += count;
+        pos += count;
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef DELTA_HPP
+#define DELTA_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// XOR of state against its keyframe with runs of equal bytes skipped
+// Stream of ( equal count, different count ) varint pairs, each followed by XOR-ed different bytes
+// Both buffers have to be the same size
+void encode_delta(std::span<uint8_t const> keyframe, std::span<uint8_t const> state, std::vector<uint8_t> &out);
+
+// State has to hold a copy of keyframe, delta is applied in place
+void apply_delta(std::span<uint8_t const> delta, std::span<uint8_t> state);
+
+// Length of common prefix of both buffers
+size_t equal_bytes(uint8_t const *l, uint8_t const *r, size_t size);
+
+#endif
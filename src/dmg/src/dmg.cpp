@@ -0,0 +1,423 @@
+#include "dmg_impl.hpp"
+#include <array>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+extern std::vector<uint8_t> read_file(const std::filesystem::path file_path, int size);
+extern std::vector<uint8_t> load_rom(std::filesystem::path const &rom_file);
+extern std::array<uint8_t, 256> load_boot_rom(std::filesystem::path const &boot_rom_file);
+
+namespace
+{
+
+// https://gbdev.io/pandocs/OAM_DMA_Transfer.html
+// Transfer starts one M-cycle after the write and takes 160 M-cycles
+constexpr uint64_t DMA_DELAY_DOTS{4};
+constexpr uint64_t DMA_DOTS{160 * 4};
+constexpr uint16_t OAM_ADDR{0xFE00};
+
+registers after_boot_registers()
+{
+    registers sv;
+    sv.A() = 1;
+    sv.F() = 0xB0;
+    sv.B() = 0;
+    sv.C() = 0x13;
+    sv.D() = 0;
+    sv.E() = 0xD8;
+    sv.H() = 1;
+    sv.L() = 0x4D;
+    sv.SP() = 0xFFFE;
+    sv.PC() = 0x0100;
+    return sv;
+}
+
+} // namespace
+
+video_output::video_output(drawing_device &target) : m_target{target}
+{
+}
+
+void video_output::after_line(uint8_t y, line_view pixels)
+{
+    if (m_enabled)
+        m_target.after_line(y, pixels);
+}
+
+void video_output::after_frame(frame_view frame)
+{
+    ++m_frames;
+    if (m_enabled)
+        m_target.after_frame(frame);
+}
+
+dmg::dmg_impl::dmg_impl(std::vector<uint8_t> const &rom, drawing_device &drawing_device,
+                        std::array<uint8_t, 0xFF + 1> const *boot_rom)
+    : m_video_output{drawing_device}, m_mem{rom, boot_rom},
+      m_cpu{*this, [this](registers const &, opcode const &) { ++m_instructions; },
+            boot_rom ? registers{} : after_boot_registers()},
+      m_ppu{*this, m_video_output}
+{
+    if (!boot_rom)
+        skip_boot();
+}
+
+dmg::dmg_impl::dmg_impl(dmg_impl const &other, drawing_device &drawing_device)
+    : dmg_state{other}, m_video_output{drawing_device}, m_mem{other.m_mem},
+      m_cpu{*this, [this](registers const &, opcode const &) { ++m_instructions; }, registers{}},
+      m_ppu{*this, m_video_output}, m_serial_output{other.m_serial_output}
+{
+    load_machine(other);
+    // the same pixels without a thread per fork
+    renderer const r = other.m_ppu.current_renderer();
+    m_ppu.set_renderer(r == renderer::THREADED ? renderer::SCANLINE : r);
+}
+
+void dmg::dmg_impl::load_machine(dmg_impl const &other)
+{
+    static_cast<dmg_state &>(*this) = other;
+    m_mem = other.m_mem;
+    m_serial_output = other.m_serial_output;
+    // setting first, loaded state keeps the skip phase of the other
+    m_ppu.set_frame_skip(other.m_ppu.frame_skip());
+    m_cpu.load_state(other.m_cpu.save_state());
+    m_ppu.load_state(other.m_ppu.save_state());
+}
+
+void dmg::dmg_impl::skip_boot()
+{
+    // https://gbdev.io/pandocs/Power_Up_Sequence.html#hardware-registers
+    m_mem.write(0xFF00, 0xCF);
+    m_mem.write(0xFF02, 0x7E);
+    m_mem.write(0xFF04, 0xAB);
+    m_mem.write(0xFF07, 0xF8);
+    m_mem.write(0xFF0F, 0xE1);
+    m_mem.write(0xFF40, 0x91);
+    m_mem.write(0xFF41, 0x85);
+    m_mem.write(0xFF46, 0xFF);
+    m_mem.write(0xFF47, 0xFC);
+    for (uint16_t addr = 0xFF40; addr <= 0xFF4B; ++addr)
+        m_ppu.register_written(addr, m_mem.peek(addr));
+}
+
+uint8_t dmg::dmg_impl::read(uint16_t addr, device d, bool)
+{
+    if (addr == 0xFF00)
+    {
+        // 1 - is not pressed
+        // 0 - is pressed
+        switch (m_joypad_mode)
+        {
+        case Joypad::ALL:
+            return 0xFF;
+        case Joypad::BUTTONS: {
+            if ((m_joypad_buttons & 0x03) < 7)
+                m_cpu.resume();
+            return m_joypad_buttons;
+        }
+        case Joypad::INPUT:
+            if ((m_joypad_buttons & 0x03) < 7)
+                m_cpu.resume();
+            return m_joypad_input;
+        }
+    }
+
+    // CPU is left with IO and HRAM while DMA holds the bus
+    if (d == device::CPU && addr < 0xFF00 && dma_active())
+        return dma_bus_read(addr);
+
+    return m_mem.read(addr, d);
+}
+
+void dmg::dmg_impl::start_dma(uint8_t source_page)
+{
+    // 0xE0-0xFF read work RAM through its echo
+    m_dma_source = static_cast<uint16_t>(source_page >= 0xE0 ? source_page - 0x20 : source_page) << 8;
+    m_dma_start = m_dots + DMA_DELAY_DOTS;
+    m_dma_end = m_dma_start + DMA_DOTS;
+
+    // whole OAM at once, the bus stays taken for the time a byte by byte copy would take
+    std::array<uint8_t, oam_mirror::OAM_SIZE> oam;
+    for (uint16_t i = 0; i < oam.size(); ++i)
+        oam[i] = m_mem.peek(m_dma_source + i);
+    m_mem.write_block(OAM_ADDR, oam);
+    m_ppu.oam_dma(oam);
+}
+
+uint8_t dmg::dmg_impl::dma_bus_read(uint16_t addr)
+{
+    // OAM is not readable, other bus than the one DMA reads from works
+    if (addr >= OAM_ADDR)
+        return 0xFF;
+    bool const vram = addr >= 0x8000 && addr <= 0x9FFF;
+    bool const source_vram = m_dma_source >= 0x8000 && m_dma_source <= 0x9FFF;
+    if (vram != source_vram)
+        return m_mem.read(addr, device::CPU);
+
+    // bus conflict, CPU gets the byte which is being copied
+    return m_mem.peek(m_dma_source + (m_dots - m_dma_start) / 4);
+}
+
+void dmg::dmg_impl::write(uint16_t addr, uint8_t data, device d, bool direct)
+{
+    // Joypad
+    if (addr == 0xFF00)
+    {
+        if (!checkbit(data, 5))
+            m_joypad_mode = Joypad::BUTTONS;
+        else if (!checkbit(data, 4))
+            m_joypad_mode = Joypad::INPUT;
+        else if (checkbit(data, 5) && checkbit(data, 4))
+            m_joypad_mode = Joypad::ALL;
+    }
+
+    // Serial transfer start, byte to send is already in SB
+    if (addr == 0xFF02 && d == device::CPU && !direct && checkbit(data, 7))
+        m_serial_output.push_back(static_cast<char>(m_mem.read(0xFF01)));
+
+    // Divider register, any value resets its value to 0x00
+    // Normal CPU update of this registry is with flag "direct"
+    if (addr == 0xFF04 && !direct)
+    {
+        m_mem.write(0xFF04, 0);
+        return;
+    }
+
+    // OAM belongs to DMA while it runs
+    if (addr >= OAM_ADDR && addr <= 0xFE9F && d == device::CPU && dma_active())
+        return;
+
+    m_mem.write(addr, data, d);
+
+    if (addr >= 0x8000 && addr <= 0x9FFF)
+        m_ppu.vram_written(addr);
+    else if (addr >= 0xFE00 && addr <= 0xFE9F)
+        m_ppu.oam_written(addr, m_mem.peek(addr));
+    else if (addr >= 0xFF40 && addr <= 0xFF4B && d == device::CPU)
+    {
+        m_ppu.register_written(addr, m_mem.peek(addr));
+        if (addr == 0xFF46)
+            start_dma(data);
+    }
+}
+
+void dmg::dmg_impl::dot()
+{
+    // CPU counts T-states, so it is ticked on every dot
+    // PPU reads do not move CPU, timing does not depend on the renderer
+    m_ppu.dot();
+    m_cpu.tick();
+    ++m_dots;
+}
+
+void dmg::dmg_impl::key_event(key_action a, key k)
+{
+    if (a == key_action::down) // press
+    {
+        if (k == key::RIGHT)
+            clearbit(m_joypad_input, 0);
+        if (k == key::LEFT)
+            clearbit(m_joypad_input, 1);
+        if (k == key::UP)
+            clearbit(m_joypad_input, 2);
+        if (k == key::DOWN)
+            clearbit(m_joypad_input, 3);
+
+        if (k == key::A)
+            clearbit(m_joypad_buttons, 0);
+        if (k == key::B)
+            clearbit(m_joypad_buttons, 1);
+        if (k == key::SELECT)
+            clearbit(m_joypad_buttons, 2);
+        if (k == key::START)
+            clearbit(m_joypad_buttons, 3);
+
+        // Joypad INT
+        uint8_t IF = m_mem.read(0xFF0F);
+        setbit(IF, 4);
+        m_mem.write(0xFF0F, IF);
+    }
+    else
+    {
+        if (k == key::RIGHT)
+            setbit(m_joypad_input, 0);
+        if (k == key::LEFT)
+            setbit(m_joypad_input, 1);
+        if (k == key::UP)
+            setbit(m_joypad_input, 2);
+        if (k == key::DOWN)
+            setbit(m_joypad_input, 3);
+
+        if (k == key::A)
+            setbit(m_joypad_buttons, 0);
+        if (k == key::B)
+            setbit(m_joypad_buttons, 1);
+        if (k == key::SELECT)
+            setbit(m_joypad_buttons, 2);
+        if (k == key::START)
+            setbit(m_joypad_buttons, 3);
+    }
+}
+
+// ******************************************
+//                  DMG PART
+// ******************************************
+dmg::dmg(std::filesystem::path const &rom_file, drawing_device &drawing_device, boot_mode mode,
+         std::filesystem::path const &boot_rom_file)
+{
+    std::vector<uint8_t> const rom{load_rom(rom_file)};
+    if (mode == boot_mode::BOOT_ROM)
+    {
+        std::array<uint8_t, 256> const boot_rom{load_boot_rom(boot_rom_file)};
+        m_pimpl = std::make_unique<dmg_impl>(rom, drawing_device, &boot_rom);
+    }
+    else
+        m_pimpl = std::make_unique<dmg_impl>(rom, drawing_device, nullptr);
+}
+
+dmg::dmg(std::unique_ptr<dmg_impl> impl) : m_pimpl{std::move(impl)}
+{
+}
+
+dmg::dmg(dmg &&other) noexcept = default;
+dmg &dmg::operator=(dmg &&other) noexcept = default;
+dmg::~dmg() = default;
+
+dmg dmg::fork() const
+{
+    return fork(m_pimpl->m_video_output.m_target);
+}
+
+dmg dmg::fork(drawing_device &drawing_device) const
+{
+    return dmg{std::make_unique<dmg_impl>(*m_pimpl, drawing_device)};
+}
+
+void dmg::dot()
+{
+    m_pimpl->dot();
+}
+
+void dmg::run_dots(uint64_t dots)
+{
+    for (uint64_t i = 0; i < dots; ++i)
+        m_pimpl->dot();
+}
+
+void dmg::run_frame()
+{
+    run_dots(DOTS_PER_FRAME);
+}
+
+void dmg::run_frame_ahead(uint32_t frames)
+{
+    if (!frames)
+    {
+        run_frame();
+        return;
+    }
+
+    // real frame is not shown, its state is kept
+    bool const enabled = m_pimpl->m_video_output.m_enabled;
+    m_pimpl->m_video_output.m_enabled = false;
+    run_frame();
+    m_pimpl->m_video_output.m_enabled = enabled;
+
+    // speculative frames run on the run-ahead machine, this one is not touched, so nothing has to be restored
+    // it is created once and loaded each frame, the shown frame is drawn into the buffer of this machine
+    dmg_impl &self = *m_pimpl;
+    if (!self.m_ahead)
+        self.m_ahead = std::make_unique<dmg_impl>(self, self.m_video_output.m_target);
+    else
+        self.m_ahead->load_machine(self);
+    dmg_impl &ahead = *self.m_ahead;
+    self.m_ppu.frame_buffer_changed();
+    ahead.m_ppu.set_frame_buffer(self.m_ppu.current_frame_buffer());
+
+    ahead.m_video_output.m_enabled = false;
+    for (uint64_t i = 0; i < uint64_t{frames - 1} * DOTS_PER_FRAME; ++i)
+        ahead.dot();
+    // stops right after the shown frame, lines of the next one would overwrite it in the buffer
+    ahead.m_video_output.m_enabled = enabled;
+    uint64_t const frames_done = ahead.m_video_output.m_frames;
+    for (uint64_t i = 0; i < DOTS_PER_FRAME && ahead.m_video_output.m_frames == frames_done; ++i)
+        ahead.dot();
+}
+
+void dmg::set_video_output(bool enabled)
+{
+    m_pimpl->m_video_output.m_enabled = enabled;
+}
+
+void dmg::set_frame_buffer(frame_buffer buffer)
+{
+    m_pimpl->m_ppu.set_frame_buffer(buffer);
+}
+
+void dmg::set_renderer(renderer r)
+{
+    m_pimpl->m_ppu.set_renderer(r);
+}
+
+void dmg::set_frame_skip(uint32_t frames)
+{
+    m_pimpl->m_ppu.set_frame_skip(frames);
+}
+
+void dmg::key_event(key_action a, key k)
+{
+    m_pimpl->key_event(a, k);
+}
+
+uint8_t dmg::peek(uint16_t addr) const
+{
+    return m_pimpl->m_mem.peek(addr);
+}
+
+uint64_t dmg::dots() const
+{
+    return m_pimpl->m_dots;
+}
+
+uint64_t dmg::instructions() const
+{
+    return m_pimpl->m_instructions;
+}
+
+std::string const &dmg::serial_output() const
+{
+    return m_pimpl->m_serial_output;
+}
+
+void dmg::save_state(std::vector<uint8_t> &out) const
+{
+    m_pimpl->save_state(out);
+}
+
+std::vector<uint8_t> dmg::save_state() const
+{
+    std::vector<uint8_t> result;
+    m_pimpl->save_state(result);
+    return result;
+}
+
+void dmg::load_state(std::span<uint8_t const> state)
+{
+    m_pimpl->load_state(state);
+}
+
+void dmg::save_state(std::filesystem::path const &state_file) const
+{
+    std::vector<uint8_t> const state{save_state()};
+    std::ofstream ofs{state_file, std::ios_base::out | std::ios_base::binary};
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open file: " + state_file.string() + "\n");
+    ofs.write(reinterpret_cast<char const *>(state.data()), state.size());
+}
+
+void dmg::load_state(std::filesystem::path const &state_file)
+{
+    std::vector<uint8_t> const state{read_file(state_file, std::numeric_limits<int>::max())};
+    m_pimpl->load_state(state);
+}
@@ -0,0 +1,89 @@
+#ifndef DMG_IMPL_HPP
+#define DMG_IMPL_HPP
+
+#include <dmg.hpp>
+#include <cpu.hpp>
+#include <ppu.hpp>
+#include "mem.hpp"
+#include <memory>
+#include <span>
+
+// Plain data, save states copy it as a whole
+struct dmg_state
+{
+    enum class Joypad
+    {
+        BUTTONS,
+        INPUT,
+        ALL
+    } m_joypad_mode = Joypad::ALL;
+
+    uint8_t m_joypad_buttons{0xFF};
+    uint8_t m_joypad_input{0xFF};
+
+    // OAM DMA keeps the bus in dots [start, end), OAM is copied already at the register write
+    // source goes first, so the structure has no padding
+    uint16_t m_dma_source{};
+    uint64_t m_dma_start{};
+    uint64_t m_dma_end{};
+
+    uint64_t m_dots{};
+    uint64_t m_instructions{};
+};
+
+// Forwards PPU output, speculative frames run with it disabled
+struct video_output : public drawing_device
+{
+    explicit video_output(drawing_device &target);
+
+    void after_line(uint8_t y, line_view pixels) override;
+    void after_frame(frame_view frame) override;
+
+    drawing_device &m_target;
+    bool m_enabled{true};
+    // finished frames, shown or not
+    uint64_t m_frames{};
+};
+
+struct dmg::dmg_impl : public rw_device, public dmg_state
+{
+    dmg_impl(std::vector<uint8_t> const &rom, drawing_device &drawing_device, std::array<uint8_t, 0xFF + 1> const *boot_rom);
+
+    // Fork, memory pages are shared with other
+    dmg_impl(dmg_impl const &other, drawing_device &drawing_device);
+
+    // Machine state of other like in a fork, drawing device, frame buffer and renderer stay
+    void load_machine(dmg_impl const &other);
+
+    video_output m_video_output;
+    memory m_mem;
+    cpu m_cpu;
+    ppu m_ppu;
+
+    std::string m_serial_output;
+
+    // Run-ahead machine, kept between frames and loaded from this one before each use
+    std::unique_ptr<dmg_impl> m_ahead;
+
+    uint8_t read(uint16_t addr, device d, bool direct) override;
+    void write(uint16_t addr, uint8_t data, device d, bool direct) override;
+
+    void dot();
+    void key_event(key_action a, key k);
+
+    // IO registers as left by boot rom
+    void skip_boot();
+
+    void start_dma(uint8_t source_page);
+    bool dma_active() const
+    {
+        return m_dots >= m_dma_start && m_dots < m_dma_end;
+    }
+    uint8_t dma_bus_read(uint16_t addr);
+
+    // save_state.cpp
+    void save_state(std::vector<uint8_t> &out) const;
+    void load_state(std::span<uint8_t const> state);
+};
+
+#endif
@@ -1,16 +1,19 @@
+#include <algorithm>
 #include <array>
-#include <cassert>
 #include <filesystem>
 #include <fstream>
-
-const std::filesystem::path boot_rom_file{BOOT_ROM_FILE};
-const std::filesystem::path rom_file{ROM_FILE};
+#include <limits>
+#include <stdexcept>
+#include <vector>
 
 std::vector<uint8_t> read_file(const std::filesystem::path file_path, int size = std::numeric_limits<int>::max())
 {
-    assert(std::filesystem::exists(file_path));
+    if (!std::filesystem::is_regular_file(file_path))
+        throw std::runtime_error("Cannot find file: " + file_path.string() + "\n");
+
     std::ifstream ifs{file_path, std::ios_base::in | std::ios_base::binary};
-    assert(ifs.is_open());
+    if (!ifs.is_open())
+        throw std::runtime_error("Cannot open file: " + file_path.string() + "\n");
 
     ifs.seekg(0, ifs.end);
     int const file_size = ifs.tellg();
@@ -21,15 +24,15 @@ std::vector<uint8_t> read_file(const std::filesystem::path file_path, int size =
     return result;
 }
 
-std::array<uint8_t, 256> load_boot_rom()
+std::array<uint8_t, 256> load_boot_rom(std::filesystem::path const &boot_rom_file)
 {
     std::vector<uint8_t> file_content{read_file(boot_rom_file, 256)};
-    std::array<uint8_t, 256> result;
+    std::array<uint8_t, 256> result{};
     std::copy(file_content.begin(), file_content.end(), result.begin());
     return result;
 }
 
-std::vector<uint8_t> load_rom()
+std::vector<uint8_t> load_rom(std::filesystem::path const &rom_file)
 {
     return read_file(rom_file);
-}
\ No newline at end of file
+}
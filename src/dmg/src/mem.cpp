@@ -0,0 +1,79 @@
+#include "mem.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+memory::memory(std::vector<uint8_t> const &rom, std::array<uint8_t, 0xFF + 1> const *boot_rom_content)
+{
+    if (boot_rom_content)
+        boot_rom = *boot_rom_content;
+    else
+        boot = false;
+
+    for (auto &p : m_pages)
+        p = std::make_shared<page>();
+
+    // No memory bank controller, only first 32KB of cartridge are visible
+    size_t const rom_size = std::min<size_t>(rom.size(), 0x8000);
+    for (size_t i = 0; i < rom_size; i += PAGE_SIZE)
+        std::copy_n(rom.begin() + i, std::min(PAGE_SIZE, rom_size - i), m_pages[i / PAGE_SIZE]->begin());
+}
+
+memory::page &memory::writable_page(uint16_t addr)
+{
+    std::shared_ptr<page> &p = m_pages[addr / PAGE_SIZE];
+    if (p.use_count() > 1)
+        p = std::make_shared<page>(*p);
+    return *p;
+}
+
+uint8_t memory::read(uint16_t addr, device d, bool)
+{
+    if (boot && d == device::CPU && addr <= 0x100)
+        return boot_rom[addr];
+    else
+        return peek(addr);
+}
+
+void memory::write(uint16_t addr, uint8_t data, device, bool)
+{
+    if (addr == 0xFF50 && data == 0x1)
+    {
+        boot = false;
+        return;
+    }
+
+    // prevent from changing Cardridge ROM by BootRom
+    if (addr <= 0x7fff)
+        return;
+
+    writable_page(addr)[addr % PAGE_SIZE] = data;
+}
+
+void memory::write_block(uint16_t addr, std::span<uint8_t const> data)
+{
+    assert(addr % PAGE_SIZE + data.size() <= PAGE_SIZE);
+    std::copy(data.begin(), data.end(), writable_page(addr).begin() + addr % PAGE_SIZE);
+}
+
+void memory::copy_to(std::span<uint8_t, 0x10000> out) const
+{
+    for (size_t i = 0; i < PAGE_COUNT; ++i)
+        std::memcpy(out.data() + i * PAGE_SIZE, m_pages[i]->data(), PAGE_SIZE);
+}
+
+void memory::copy_from(std::span<uint8_t const, 0x10000> in)
+{
+    for (size_t i = 0; i < PAGE_COUNT; ++i)
+    {
+        uint8_t const *src = in.data() + i * PAGE_SIZE;
+        // unchanged pages stay shared
+        if (std::memcmp(m_pages[i]->data(), src, PAGE_SIZE) != 0)
+            std::memcpy(writable_page(static_cast<uint16_t>(i * PAGE_SIZE)).data(), src, PAGE_SIZE);
+    }
+}
+
+size_t memory::shared_pages() const
+{
+    return std::count_if(m_pages.begin(), m_pages.end(), [](auto const &p) { return p.use_count() > 1; });
+}
@@ -0,0 +1,53 @@
+#ifndef __MEMORY_HPP__
+#define __MEMORY_HPP__
+
+#include <common.hpp>
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Address space is split into reference counted pages
+// Copies share all pages, first write to a shared page gives the writer its own copy
+class memory : public rw_device
+{
+  public:
+    static constexpr size_t PAGE_SIZE{0x100};
+    static constexpr size_t PAGE_COUNT{0x10000 / PAGE_SIZE};
+    using page = std::array<uint8_t, PAGE_SIZE>;
+
+    // Without boot rom memory starts as if boot rom was already swapped out
+    memory(std::vector<uint8_t> const &rom, std::array<uint8_t, 0xFF + 1> const *boot_rom = nullptr);
+    memory(memory const &other) = default;
+    // Shares all pages of other like a copy
+    memory &operator=(memory const &other) = default;
+
+    uint8_t read(uint16_t addr, device d = device::CPU, bool direct = false) override;
+    void write(uint16_t addr, uint8_t data, device d = device::CPU, bool direct = false) override;
+
+    // Raw content, boot rom overlay is not applied
+    uint8_t peek(uint16_t addr) const
+    {
+        return (*m_pages[addr / PAGE_SIZE])[addr % PAGE_SIZE];
+    }
+
+    // Range has to be within one page, e.g. OAM
+    void write_block(uint16_t addr, std::span<uint8_t const> data);
+
+    void copy_to(std::span<uint8_t, 0x10000> out) const;
+    void copy_from(std::span<uint8_t const, 0x10000> in);
+
+    // Pages used also by other copies
+    size_t shared_pages() const;
+
+    // private:
+    bool boot{true};
+    std::array<uint8_t, 0xFF + 1> boot_rom{};
+
+  private:
+    std::array<std::shared_ptr<page>, PAGE_COUNT> m_pages;
+
+    page &writable_page(uint16_t addr);
+};
+
+#endif
@@ -0,0 +1,85 @@
+#include <movie.hpp>
+#include <dmg.hpp>
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+
+std::array<std::pair<std::string_view, key>, 8> const KEYS_STR{{{"UP", key::UP},
+                                                                {"DOWN", key::DOWN},
+                                                                {"LEFT", key::LEFT},
+                                                                {"RIGHT", key::RIGHT},
+                                                                {"START", key::START},
+                                                                {"SELECT", key::SELECT},
+                                                                {"A", key::A},
+                                                                {"B", key::B}}};
+
+input_event parse_event(std::string const &line, std::filesystem::path const &movie_file, int line_number)
+{
+    auto error = [&]() {
+        std::stringstream ss;
+        ss << movie_file.string() << ":" << line_number << ": invalid input event [" << line << "]\n";
+        return std::runtime_error(ss.str());
+    };
+
+    std::istringstream iss{line};
+    input_event result;
+    std::string key_str, action_str;
+    if (!(iss >> result.m_frame >> key_str >> action_str))
+        throw error();
+
+    auto const k = std::find_if(KEYS_STR.begin(), KEYS_STR.end(), [&](auto const &p) { return p.first == key_str; });
+    if (k == KEYS_STR.end())
+        throw error();
+    result.m_key = k->second;
+
+    if (action_str == "down")
+        result.m_action = key_action::down;
+    else if (action_str == "up")
+        result.m_action = key_action::up;
+    else
+        throw error();
+
+    return result;
+}
+
+} // namespace
+
+movie load_movie(std::filesystem::path const &movie_file)
+{
+    std::ifstream ifs{movie_file};
+    if (!ifs.is_open())
+        throw std::runtime_error("Cannot open file: " + movie_file.string() + "\n");
+
+    movie result;
+    std::string line;
+    int line_number{};
+    while (std::getline(ifs, line))
+    {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+        result.push_back(parse_event(line, movie_file, line_number));
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](auto const &l, auto const &r) { return l.m_frame < r.m_frame; });
+    return result;
+}
+
+void play_movie(dmg &gameboy, movie const &m, uint64_t frames, uint32_t run_ahead)
+{
+    auto next = m.begin();
+    for (uint64_t frame = 0; frame < frames; ++frame)
+    {
+        for (; next != m.end() && next->m_frame <= frame; ++next)
+            gameboy.key_event(next->m_action, next->m_key);
+        gameboy.run_frame_ahead(run_ahead);
+    }
+}
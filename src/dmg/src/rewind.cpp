@@ -0,0 +1,170 @@
+#include <rewind.hpp>
+#include <dmg.hpp>
+#include "delta.hpp"
+#include <algorithm>
+#include <cassert>
+
+size_t rewind_buffer::group::snapshots() const
+{
+    return 1 + (m_delta_offsets.empty() ? 0 : m_delta_offsets.size() - 1);
+}
+
+size_t rewind_buffer::group::bytes() const
+{
+    return m_keyframe.size() + m_deltas.size() + m_delta_offsets.size() * sizeof(size_t);
+}
+
+rewind_buffer::rewind_buffer(dmg &gameboy, uint32_t snapshot_interval, uint32_t keyframe_interval, size_t capacity)
+    : m_gameboy{gameboy}, m_snapshot_interval{std::max(1u, snapshot_interval)},
+      m_keyframe_interval{std::max(1u, keyframe_interval)}, m_capacity{capacity}
+{
+}
+
+void rewind_buffer::key_event(key_action a, key k)
+{
+    m_pending_inputs.push_back({m_frame, a, k});
+}
+
+void rewind_buffer::apply_inputs(uint64_t frame)
+{
+    auto it = std::lower_bound(m_inputs.begin(), m_inputs.end(), frame,
+                               [](recorded_input const &i, uint64_t f) { return i.m_frame < f; });
+    for (; it != m_inputs.end() && it->m_frame == frame; ++it)
+        m_gameboy.key_event(it->m_action, it->m_key);
+}
+
+void rewind_buffer::run_frame()
+{
+    // snapshot holds state before inputs of this frame
+    if (m_frame % m_snapshot_interval == 0)
+        take_snapshot();
+
+    for (auto &i : m_pending_inputs)
+    {
+        i.m_frame = m_frame;
+        m_inputs.push_back(i);
+    }
+    m_pending_inputs.clear();
+
+    apply_inputs(m_frame);
+    m_gameboy.run_frame();
+    ++m_frame;
+}
+
+void rewind_buffer::take_snapshot()
+{
+    m_gameboy.save_state(m_state);
+
+    bool const new_group = m_groups.empty() || m_groups.back().snapshots() == m_keyframe_interval ||
+                           m_groups.back().m_keyframe.size() != m_state.size();
+    if (new_group)
+    {
+        group &g = m_groups.emplace_back();
+        g.m_first_frame = m_frame;
+        g.m_keyframe = m_state;
+        m_memory_used += g.bytes();
+    }
+    else
+    {
+        group &g = m_groups.back();
+        m_memory_used -= g.bytes();
+        if (g.m_delta_offsets.empty())
+            g.m_delta_offsets.push_back(0);
+        encode_delta(g.m_keyframe, m_state, g.m_deltas);
+        g.m_delta_offsets.push_back(g.m_deltas.size());
+        m_memory_used += g.bytes();
+    }
+
+    // drop oldest history, current group always stays
+    while (m_memory_used > m_capacity && m_groups.size() > 1)
+    {
+        m_memory_used -= m_groups.front().bytes();
+        m_groups.pop_front();
+
+        uint64_t const first = m_groups.front().m_first_frame;
+        while (!m_inputs.empty() && m_inputs.front().m_frame < first)
+            m_inputs.pop_front();
+    }
+}
+
+void rewind_buffer::restore(group const &g, size_t snapshot)
+{
+    m_state = g.m_keyframe;
+    if (snapshot > 0)
+    {
+        std::span<uint8_t const> const all{g.m_deltas};
+        size_t const begin = g.m_delta_offsets[snapshot - 1];
+        size_t const end = g.m_delta_offsets[snapshot];
+        apply_delta(all.subspan(begin, end - begin), m_state);
+    }
+    m_gameboy.load_state(m_state);
+}
+
+void rewind_buffer::truncate_after(uint64_t frame)
+{
+    // history from given frame on belongs to abandoned timeline, it is recorded again by run_frame
+    while (!m_groups.empty() && m_groups.back().m_first_frame >= frame)
+    {
+        m_memory_used -= m_groups.back().bytes();
+        m_groups.pop_back();
+    }
+
+    if (!m_groups.empty())
+    {
+        group &g = m_groups.back();
+        size_t const keep = (frame - g.m_first_frame + m_snapshot_interval - 1) / m_snapshot_interval;
+        if (keep < g.snapshots())
+        {
+            m_memory_used -= g.bytes();
+            g.m_deltas.resize(g.m_delta_offsets[keep - 1]);
+            g.m_delta_offsets.resize(keep == 1 ? 0 : keep);
+            m_memory_used += g.bytes();
+        }
+    }
+
+    while (!m_inputs.empty() && m_inputs.back().m_frame >= frame)
+        m_inputs.pop_back();
+    m_pending_inputs.clear();
+}
+
+bool rewind_buffer::step_back()
+{
+    if (m_frame == 0 || m_groups.empty() || m_frame - 1 < m_groups.front().m_first_frame)
+        return false;
+
+    uint64_t const target = m_frame - 1;
+
+    auto g = std::find_if(m_groups.rbegin(), m_groups.rend(), [target](group const &g) { return g.m_first_frame <= target; });
+    assert(g != m_groups.rend());
+
+    size_t const snapshot = std::min<size_t>((target - g->m_first_frame) / m_snapshot_interval, g->snapshots() - 1);
+    uint64_t const snapshot_frame = g->m_first_frame + snapshot * m_snapshot_interval;
+
+    restore(*g, snapshot);
+
+    // re-simulate from snapshot up to target with recorded inputs
+    for (uint64_t f = snapshot_frame; f < target; ++f)
+    {
+        apply_inputs(f);
+        m_gameboy.run_frame();
+    }
+
+    m_frame = target;
+    truncate_after(target);
+    return true;
+}
+
+uint64_t rewind_buffer::frame() const
+{
+    return m_frame;
+}
+
+uint64_t rewind_buffer::oldest_frame() const
+{
+    return m_groups.empty() ? m_frame : m_groups.front().m_first_frame;
+}
+
+size_t rewind_buffer::memory_used() const
+{
+    return m_memory_used;
+}
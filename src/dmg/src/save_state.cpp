@@ -0,0 +1,125 @@
+#include "dmg_impl.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+
+constexpr std::array<char, 4> STATE_MAGIC{'G', 'B', 'S', 'T'};
+
+// Increment on every change of saved structures
+constexpr uint32_t STATE_VERSION{10};
+
+// Layout: header | cpu_state | ppu_state | dmg_state | memory | boot rom | serial output
+struct state_header
+{
+    std::array<char, 4> m_magic{};
+    uint32_t m_version{};
+
+    // Structures are copied as they are, sizes catch builds with other layout
+    uint32_t m_cpu_size{};
+    uint32_t m_ppu_size{};
+    uint32_t m_dmg_size{};
+
+    uint32_t m_serial_size{};
+    uint32_t m_boot{};
+};
+
+// No padding either, same machine gives the same bytes
+static_assert(std::has_unique_object_representations_v<cpu_state>);
+static_assert(std::has_unique_object_representations_v<ppu_state>);
+static_assert(std::has_unique_object_representations_v<dmg_state>);
+
+constexpr size_t MEMORY_SIZE{memory::PAGE_SIZE * memory::PAGE_COUNT};
+using boot_rom_t = decltype(memory::boot_rom);
+
+constexpr size_t FIXED_SIZE{sizeof(state_header) + sizeof(cpu_state) + sizeof(ppu_state) + sizeof(dmg_state) +
+                            MEMORY_SIZE + sizeof(boot_rom_t)};
+
+struct writer
+{
+    uint8_t *m_pos;
+
+    template <typename T>
+    void put(T const &value)
+    {
+        std::memcpy(m_pos, &value, sizeof(T));
+        m_pos += sizeof(T);
+    }
+};
+
+struct reader
+{
+    uint8_t const *m_pos;
+
+    template <typename T>
+    void get(T &value)
+    {
+        std::memcpy(&value, m_pos, sizeof(T));
+        m_pos += sizeof(T);
+    }
+};
+
+} // namespace
+
+void dmg::dmg_impl::save_state(std::vector<uint8_t> &out) const
+{
+    state_header header;
+    header.m_magic = STATE_MAGIC;
+    header.m_version = STATE_VERSION;
+    header.m_cpu_size = sizeof(cpu_state);
+    header.m_ppu_size = sizeof(ppu_state);
+    header.m_dmg_size = sizeof(dmg_state);
+    header.m_serial_size = static_cast<uint32_t>(m_serial_output.size());
+    header.m_boot = m_mem.boot;
+
+    out.resize(FIXED_SIZE + m_serial_output.size());
+
+    writer w{out.data()};
+    w.put(header);
+    w.put(m_cpu.save_state());
+    w.put(m_ppu.save_state());
+    w.put(static_cast<dmg_state const &>(*this));
+    m_mem.copy_to(std::span<uint8_t, MEMORY_SIZE>{w.m_pos, MEMORY_SIZE});
+    w.m_pos += MEMORY_SIZE;
+    w.put(m_mem.boot_rom);
+    std::memcpy(w.m_pos, m_serial_output.data(), m_serial_output.size());
+}
+
+void dmg::dmg_impl::load_state(std::span<uint8_t const> state)
+{
+    if (state.size() < FIXED_SIZE)
+        throw std::runtime_error("Save state is too small\n");
+
+    reader r{state.data()};
+    state_header header;
+    r.get(header);
+
+    if (header.m_magic != STATE_MAGIC)
+        throw std::runtime_error("Not a save state\n");
+    if (header.m_version != STATE_VERSION || header.m_cpu_size != sizeof(cpu_state) || header.m_ppu_size != sizeof(ppu_state) ||
+        header.m_dmg_size != sizeof(dmg_state))
+        throw std::runtime_error("Save state comes from other version of emulator\n");
+    if (state.size() != FIXED_SIZE + header.m_serial_size)
+        throw std::runtime_error("Save state has wrong size\n");
+
+    cpu_state cs;
+    r.get(cs);
+    m_cpu.load_state(cs);
+
+    ppu_state ps;
+    r.get(ps);
+
+    dmg_state ds;
+    r.get(ds);
+    static_cast<dmg_state &>(*this) = ds;
+    m_mem.copy_from(std::span<uint8_t const, MEMORY_SIZE>{r.m_pos, MEMORY_SIZE});
+    r.m_pos += MEMORY_SIZE;
+    r.get(m_mem.boot_rom);
+    m_mem.boot = header.m_boot;
+    m_serial_output.assign(reinterpret_cast<char const *>(r.m_pos), header.m_serial_size);
+
+    // ppu may copy VRAM, memory has to be restored first
+    m_ppu.load_state(ps);
+}
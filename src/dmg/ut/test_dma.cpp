@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <dmg.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct dma_tests : public ::testing::Test
+{
+    std::vector<std::filesystem::path> m_files;
+
+    void TearDown() override
+    {
+        for (auto const &file : m_files)
+            std::filesystem::remove(file);
+    }
+
+    // Starts DMA from given page, then runs from ROM: LD A, 0x55; LD (0xC100), A; JR -2
+    std::filesystem::path write_rom(uint8_t source_page)
+    {
+        std::vector<uint8_t> rom(0x8000);
+        std::vector<uint8_t> const program{0x3E, source_page, 0xE0, 0x46, 0x3E, 0x55, 0xEA, 0x00, 0xC1, 0x18, 0xFE};
+        std::copy(program.begin(), program.end(), rom.begin() + 0x100);
+
+        auto const file = std::filesystem::temp_directory_path() / ("dma_test_" + std::to_string(source_page) + ".gb");
+        std::ofstream ofs{file, std::ios_base::out | std::ios_base::binary};
+        ofs.write(reinterpret_cast<char const *>(rom.data()), rom.size());
+        m_files.push_back(file);
+        return file;
+    }
+};
+
+} // namespace
+
+TEST_F(dma_tests, cpu_reads_transferred_byte_on_the_same_bus)
+{
+    // ROM and work RAM share the bus, instructions after the write are read as source bytes, zeros are NOPs
+    null_device screen;
+    dmg gameboy{write_rom(0xC0), screen, boot_mode::SKIP};
+    gameboy.run_dots(1000);
+    ASSERT_EQ(gameboy.peek(0xFF46), 0xC0);
+    ASSERT_EQ(gameboy.peek(0xC100), 0x00);
+}
+
+TEST_F(dma_tests, other_bus_is_free)
+{
+    // VRAM as source leaves ROM to CPU
+    null_device screen;
+    dmg gameboy{write_rom(0x80), screen, boot_mode::SKIP};
+    gameboy.run_dots(1000);
+    ASSERT_EQ(gameboy.peek(0xC100), 0x55);
+}
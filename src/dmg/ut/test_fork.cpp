@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <dmg.hpp>
+
+#include <array>
+#include <vector>
+
+namespace
+{
+
+std::filesystem::path const resources{RESOURCES_DIR};
+std::filesystem::path const rom{resources / "TetrisJUEV1.1.gb"};
+
+std::array<uint8_t, 0x10000> dump(dmg const &gameboy)
+{
+    std::array<uint8_t, 0x10000> result;
+    for (uint32_t addr = 0; addr <= 0xFFFF; ++addr)
+        result[addr] = gameboy.peek(addr);
+    return result;
+}
+
+void run_frames(dmg &gameboy, int frames)
+{
+    for (int i = 0; i < frames; ++i)
+        gameboy.run_frame();
+}
+
+} // namespace
+
+TEST(fork_tests, child_continues_like_parent)
+{
+    null_device screen;
+    dmg parent{rom, screen, boot_mode::SKIP};
+    run_frames(parent, 100);
+    parent.run_dots(1234);
+
+    dmg child{parent.fork()};
+    ASSERT_EQ(dump(child), dump(parent));
+
+    run_frames(parent, 50);
+    run_frames(child, 50);
+    ASSERT_EQ(child.instructions(), parent.instructions());
+    ASSERT_EQ(dump(child), dump(parent));
+}
+
+TEST(fork_tests, children_do_not_affect_each_other)
+{
+    null_device screen;
+    dmg parent{rom, screen, boot_mode::SKIP};
+    run_frames(parent, 100);
+    auto const parent_memory = dump(parent);
+    auto const parent_instructions = parent.instructions();
+
+    dmg pressed{parent.fork()};
+    dmg released{parent.fork()};
+    pressed.key_event(key_action::down, key::START);
+    run_frames(pressed, 30);
+    run_frames(released, 30);
+
+    ASSERT_EQ(dump(parent), parent_memory);
+    ASSERT_EQ(parent.instructions(), parent_instructions);
+    ASSERT_NE(dump(pressed), dump(released));
+
+    // released child is the same as plain continuation of parent
+    run_frames(parent, 30);
+    ASSERT_EQ(dump(released), dump(parent));
+}
+
+namespace
+{
+
+// Last completed frame
+struct recording_device : public drawing_device
+{
+    std::vector<color> m_pixels;
+    int m_frames{};
+
+    void after_frame(frame_view frame) override
+    {
+        m_pixels.assign(frame.begin(), frame.end());
+        ++m_frames;
+    }
+};
+
+} // namespace
+
+TEST(run_ahead_tests, machine_advances_one_frame)
+{
+    null_device screen;
+    dmg plain{rom, screen, boot_mode::SKIP};
+    dmg ahead{rom, screen, boot_mode::SKIP};
+    for (int i = 0; i < 60; ++i)
+    {
+        if (i == 40)
+        {
+            plain.key_event(key_action::down, key::START);
+            ahead.key_event(key_action::down, key::START);
+        }
+        plain.run_frame();
+        ahead.run_frame_ahead(3);
+    }
+    ASSERT_EQ(ahead.dots(), plain.dots());
+    ASSERT_EQ(ahead.instructions(), plain.instructions());
+    ASSERT_EQ(dump(ahead), dump(plain));
+}
+
+TEST(run_ahead_tests, shows_frame_ahead)
+{
+    constexpr uint32_t frames_ahead{3};
+    recording_device plain_screen, ahead_screen;
+    dmg plain{rom, plain_screen, boot_mode::SKIP};
+    dmg ahead{rom, ahead_screen, boot_mode::SKIP};
+
+    run_frames(plain, 100 + frames_ahead - 1);
+    run_frames(ahead, 99);
+
+    plain_screen.m_pixels.clear();
+    ahead_screen.m_pixels.clear();
+    plain.run_frame();
+    ahead_screen.m_frames = 0;
+    ahead.run_frame_ahead(frames_ahead);
+
+    // only last speculative frame reaches the device
+    ASSERT_EQ(ahead_screen.m_frames, 1);
+    ASSERT_FALSE(ahead_screen.m_pixels.empty());
+    ASSERT_EQ(ahead_screen.m_pixels, plain_screen.m_pixels);
+}
+
+TEST(run_ahead_tests, shown_frame_is_in_caller_buffer)
+{
+    constexpr uint32_t frames_ahead{3};
+    recording_device plain_screen, ahead_screen;
+    dmg plain{rom, plain_screen, boot_mode::SKIP};
+    dmg ahead{rom, ahead_screen, boot_mode::SKIP};
+    std::vector<color> buffer(SCREEN_WIDTH * SCREEN_HEIGHT);
+    ahead.set_frame_buffer(frame_buffer{buffer.data(), buffer.size()});
+    // its lines are finished before the run-ahead machine draws into the same buffer
+    ahead.set_renderer(renderer::THREADED);
+
+    // through title screen and menus to falling pieces, which move every 16 frames,
+    // so hidden and shown frames differ
+    for (int i = 0; i < 370; ++i)
+    {
+        for (dmg *gameboy : {&plain, &ahead})
+        {
+            if (i >= 200 && i % 40 == 0)
+                gameboy->key_event(key_action::down, key::START);
+            if (i >= 200 && i % 40 == 5)
+                gameboy->key_event(key_action::up, key::START);
+            gameboy->run_frame();
+        }
+    }
+    run_frames(plain, frames_ahead);
+
+    for (int i = 0; i < 40; ++i)
+    {
+        plain.run_frame();
+        ahead.run_frame_ahead(frames_ahead);
+        ASSERT_EQ(ahead_screen.m_pixels, plain_screen.m_pixels);
+        ASSERT_EQ(buffer, plain_screen.m_pixels);
+    }
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <dmg.hpp>
+#include <movie.hpp>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace
+{
+
+std::filesystem::path const resources{RESOURCES_DIR};
+
+// Hash of every completed frame
+struct hashing_device : public drawing_device
+{
+    std::vector<uint64_t> m_frames;
+
+    void after_frame(frame_view frame) override
+    {
+        uint64_t hash{14695981039346656037ull};
+        for (color c : frame)
+            hash = (hash ^ c) * 1099511628211ull;
+        m_frames.push_back(hash);
+    }
+};
+
+std::vector<uint64_t> run(std::filesystem::path const &rom, renderer r, movie const &input, uint64_t frames)
+{
+    hashing_device screen;
+    dmg gameboy{rom, screen, boot_mode::SKIP};
+    gameboy.set_renderer(r);
+    play_movie(gameboy, input, frames);
+    return screen.m_frames;
+}
+
+// Lines as they are reported, checks they come in order and make up the frame
+struct line_device : public drawing_device
+{
+    std::vector<color> m_lines;
+    color const *m_frame_data{};
+    int m_checked_frames{};
+    int m_next_line{};
+
+    void after_line(uint8_t y, line_view pixels) override
+    {
+        EXPECT_EQ(y, m_next_line);
+        m_next_line = (m_next_line + 1) % SCREEN_HEIGHT;
+        m_lines.insert(m_lines.end(), pixels.begin(), pixels.end());
+    }
+
+    void after_frame(frame_view frame) override
+    {
+        if (m_lines.size() == frame.size())
+        {
+            EXPECT_TRUE(std::equal(frame.begin(), frame.end(), m_lines.begin()));
+            ++m_checked_frames;
+        }
+        m_frame_data = frame.data();
+        m_lines.clear();
+    }
+};
+
+void expect_same_frames(std::filesystem::path const &rom, movie const &input, uint64_t frames)
+{
+    auto const fifo = run(rom, renderer::FIFO, input, frames);
+    auto const scanline = run(rom, renderer::SCANLINE, input, frames);
+    auto const threaded = run(rom, renderer::THREADED, input, frames);
+    ASSERT_EQ(fifo.size(), scanline.size());
+    ASSERT_EQ(fifo.size(), threaded.size());
+    for (size_t i = 0; i < fifo.size(); ++i)
+    {
+        ASSERT_EQ(fifo[i], scanline[i]) << "frame " << i;
+        ASSERT_EQ(fifo[i], threaded[i]) << "frame " << i;
+    }
+
+    // something was drawn
+    ASSERT_GT(std::set<uint64_t>(fifo.begin(), fifo.end()).size(), 1u);
+}
+
+} // namespace
+
+TEST(renderer_tests, tetris_frames_are_the_same)
+{
+    // title screen, game type menu and falling pieces
+    movie const input{{200, key::START, key_action::down}, {205, key::START, key_action::up},
+                      {240, key::START, key_action::down}, {245, key::START, key_action::up},
+                      {280, key::START, key_action::down}, {285, key::START, key_action::up},
+                      {330, key::LEFT, key_action::down},  {360, key::LEFT, key_action::up}};
+    expect_same_frames(resources / "TetrisJUEV1.1.gb", input, 500);
+}
+
+TEST(renderer_tests, test_rom_frames_are_the_same)
+{
+    expect_same_frames(resources / "01.gb", {}, 200);
+}
+
+class caller_buffer_tests : public ::testing::TestWithParam<renderer>
+{
+};
+
+TEST_P(caller_buffer_tests, frame_is_drawn_into_caller_buffer)
+{
+    std::vector<color> buffer(SCREEN_WIDTH * SCREEN_HEIGHT);
+    line_device screen;
+    dmg gameboy{resources / "TetrisJUEV1.1.gb", screen, boot_mode::SKIP};
+    gameboy.set_renderer(GetParam());
+    gameboy.set_frame_buffer(frame_buffer{buffer.data(), buffer.size()});
+    for (int i = 0; i < 200; ++i)
+        gameboy.run_frame();
+
+    // pixels are read only in drawing device calls, threaded renderer may be writing the next frame
+    ASSERT_EQ(screen.m_frame_data, buffer.data());
+    ASSERT_GT(screen.m_checked_frames, 100);
+}
+
+INSTANTIATE_TEST_SUITE_P(renderers, caller_buffer_tests, ::testing::Values(renderer::FIFO, renderer::THREADED));
+
+TEST(renderer_tests, threaded_renderer_uses_loaded_vram)
+{
+    hashing_device screen;
+    dmg gameboy{resources / "TetrisJUEV1.1.gb", screen, boot_mode::SKIP};
+    gameboy.set_renderer(renderer::SCANLINE);
+    for (int i = 0; i < 150; ++i)
+        gameboy.run_frame();
+    std::vector<uint8_t> const state{gameboy.save_state()};
+    screen.m_frames.clear();
+    for (int i = 0; i < 20; ++i)
+        gameboy.run_frame();
+
+    // title screen is already in VRAM of the state, not in the one the thread starts with
+    hashing_device threaded_screen;
+    dmg threaded{resources / "TetrisJUEV1.1.gb", threaded_screen, boot_mode::SKIP};
+    threaded.set_renderer(renderer::THREADED);
+    threaded.load_state(state);
+    for (int i = 0; i < 20; ++i)
+        threaded.run_frame();
+
+    // the first frame was partly drawn before the state was saved
+    ASSERT_EQ(screen.m_frames.size(), threaded_screen.m_frames.size());
+    ASSERT_TRUE(std::equal(screen.m_frames.begin() + 1, screen.m_frames.end(), threaded_screen.m_frames.begin() + 1));
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <dmg.hpp>
+#include <rewind.hpp>
+#include "../src/delta.hpp"
+
+#include <array>
+#include <map>
+#include <random>
+
+namespace
+{
+
+std::filesystem::path const resources{RESOURCES_DIR};
+std::filesystem::path const rom{resources / "TetrisJUEV1.1.gb"};
+
+struct machine_print
+{
+    std::array<uint8_t, 0x10000> m_memory;
+    uint64_t m_dots;
+    uint64_t m_instructions;
+    bool operator==(machine_print const &) const = default;
+};
+
+machine_print print(dmg const &gameboy)
+{
+    machine_print result;
+    for (uint32_t addr = 0; addr <= 0xFFFF; ++addr)
+        result.m_memory[addr] = gameboy.peek(addr);
+    result.m_dots = gameboy.dots();
+    result.m_instructions = gameboy.instructions();
+    return result;
+}
+
+} // namespace
+
+TEST(delta_tests, round_trip)
+{
+    std::mt19937 rng{42};
+    std::vector<uint8_t> keyframe(70000);
+    for (auto &b : keyframe)
+        b = static_cast<uint8_t>(rng());
+
+    std::vector<uint8_t> state{keyframe};
+    for (int i = 0; i < 300; ++i)
+        state[rng() % state.size()] ^= static_cast<uint8_t>(rng() | 1);
+    state.front() ^= 0xFF;
+    state.back() ^= 0xFF;
+
+    std::vector<uint8_t> delta;
+    encode_delta(keyframe, state, delta);
+    ASSERT_LT(delta.size(), 300u * 4);
+
+    std::vector<uint8_t> restored{keyframe};
+    apply_delta(delta, restored);
+    ASSERT_EQ(restored, state);
+
+    std::vector<uint8_t> empty;
+    encode_delta(keyframe, keyframe, empty);
+    ASSERT_TRUE(empty.empty());
+}
+
+TEST(delta_tests, equal_bytes)
+{
+    std::vector<uint8_t> l(100, 7), r(100, 7);
+    ASSERT_EQ(equal_bytes(l.data(), r.data(), l.size()), 100u);
+    for (size_t i : {0, 15, 16, 17, 63, 99})
+    {
+        r[i] = 8;
+        ASSERT_EQ(equal_bytes(l.data(), r.data(), l.size()), i);
+        r[i] = 7;
+    }
+}
+
+TEST(rewind_tests, step_back_restores_previous_frames)
+{
+    null_device screen;
+    dmg gameboy{rom, screen, boot_mode::SKIP};
+    rewind_buffer rewind{gameboy, 4, 8};
+
+    std::map<uint64_t, machine_print> history;
+    for (int f = 0; f < 120; ++f)
+    {
+        if (f == 90)
+            rewind.key_event(key_action::down, key::START);
+        if (f == 97)
+            rewind.key_event(key_action::up, key::START);
+        history[rewind.frame()] = print(gameboy);
+        rewind.run_frame();
+    }
+
+    for (int i = 0; i < 40; ++i)
+    {
+        ASSERT_TRUE(rewind.step_back());
+        ASSERT_EQ(print(gameboy), history[rewind.frame()]) << "frame " << rewind.frame();
+    }
+
+    // new timeline continues from rewound frame
+    rewind.run_frame();
+    ASSERT_EQ(rewind.frame(), 81u);
+    ASSERT_TRUE(rewind.step_back());
+    ASSERT_EQ(print(gameboy), history[80]);
+}
+
+TEST(rewind_tests, history_is_limited_by_capacity)
+{
+    null_device screen;
+    dmg gameboy{rom, screen, boot_mode::SKIP};
+    rewind_buffer rewind{gameboy, 1, 10, 200 * 1024};
+
+    for (int f = 0; f < 100; ++f)
+        rewind.run_frame();
+
+    ASSERT_LE(rewind.memory_used(), 200u * 1024);
+    ASSERT_GT(rewind.oldest_frame(), 0u);
+
+    while (rewind.step_back())
+        ;
+    ASSERT_EQ(rewind.frame(), rewind.oldest_frame());
+}
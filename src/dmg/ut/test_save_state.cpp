@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <dmg.hpp>
+
+#include <array>
+
+namespace
+{
+
+std::filesystem::path const resources{RESOURCES_DIR};
+std::filesystem::path const rom{resources / "TetrisJUEV1.1.gb"};
+
+std::array<uint8_t, 0x10000> dump(dmg const &gameboy)
+{
+    std::array<uint8_t, 0x10000> result;
+    for (uint32_t addr = 0; addr <= 0xFFFF; ++addr)
+        result[addr] = gameboy.peek(addr);
+    return result;
+}
+
+void run_frames(dmg &gameboy, int frames)
+{
+    for (int i = 0; i < frames; ++i)
+        gameboy.run_frame();
+}
+
+} // namespace
+
+TEST(save_state_tests, restored_machine_continues_the_same_way)
+{
+    null_device screen;
+    dmg gameboy{rom, screen, boot_mode::SKIP};
+    run_frames(gameboy, 100);
+    // not on frame boundary
+    gameboy.run_dots(1234);
+
+    std::vector<uint8_t> const state{gameboy.save_state()};
+    run_frames(gameboy, 50);
+    auto const expected_memory = dump(gameboy);
+    auto const expected_instructions = gameboy.instructions();
+
+    gameboy.load_state(state);
+    run_frames(gameboy, 50);
+    ASSERT_EQ(gameboy.instructions(), expected_instructions);
+    ASSERT_EQ(dump(gameboy), expected_memory);
+
+    // other machine with the same cartridge
+    dmg other{rom, screen, boot_mode::SKIP};
+    other.load_state(state);
+    run_frames(other, 50);
+    ASSERT_EQ(other.instructions(), expected_instructions);
+    ASSERT_EQ(dump(other), expected_memory);
+}
+
+TEST(save_state_tests, saved_state_is_stable)
+{
+    null_device screen;
+    dmg gameboy{rom, screen, boot_mode::SKIP};
+    run_frames(gameboy, 10);
+
+    std::vector<uint8_t> first;
+    gameboy.save_state(first);
+    gameboy.load_state(first);
+    std::vector<uint8_t> second;
+    gameboy.save_state(second);
+    ASSERT_EQ(first, second);
+}
+
+TEST(save_state_tests, invalid_state_is_rejected)
+{
+    null_device screen;
+    dmg gameboy{rom, screen, boot_mode::SKIP};
+    std::vector<uint8_t> state{gameboy.save_state()};
+
+    std::vector<uint8_t> const too_small(state.begin(), state.begin() + 16);
+    ASSERT_THROW(gameboy.load_state(too_small), std::runtime_error);
+
+    state[0] = 'X';
+    ASSERT_THROW(gameboy.load_state(state), std::runtime_error);
+}
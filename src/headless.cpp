@@ -0,0 +1,238 @@
+#include <command_line.hpp>
+#include <dmg.hpp>
+#include <movie.hpp>
+#include <software_screen.hpp>
+#include <video_recorder.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace
+{
+
+struct options
+{
+    std::filesystem::path rom_file;
+    std::filesystem::path boot_rom_file;
+    std::filesystem::path movie_file;
+    std::filesystem::path load_state_file;
+    std::filesystem::path save_state_file;
+    uint64_t frames{600};
+    uint32_t run_ahead{};
+    renderer line_renderer{renderer::SCANLINE};
+    uint32_t frame_skip{};
+    std::optional<uint64_t> cycles;
+    bool serial{};
+    std::filesystem::path dump_memory_file;
+    std::filesystem::path dump_frames_directory;
+    image_format dump_format{image_format::PPM};
+    std::filesystem::path record_file;
+};
+
+void usage()
+{
+    std::cout << "Usage: RM_GB_Emu_Headless <rom> [options]\n"
+                 "  --frames <n>          emulate n frames ( 70224 cycles each ), default 600\n"
+                 "  --cycles <n>          emulate n cycles ( T-states ) instead of frames\n"
+                 "  --renderer <name>     scanline ( default ), fifo or threaded\n"
+                 "  --frame-skip <n>      draw one frame, then skip n frames\n"
+                 "  --logic-only          never draw, ppu keeps only its timing\n"
+                 "  --boot-rom <file>     run boot rom first, without it boot is skipped\n"
+                 "  --movie <file>        input events to play, used with --frames\n"
+                 "  --run-ahead <n>       show frames n frames ahead, used with --frames\n"
+                 "  --load-state <file>   continue from saved state\n"
+                 "  --save-state <file>   save state after run\n"
+                 "  --serial              print data sent through serial port\n"
+                 "  --dump-memory <file>  write 64KB address space to file after run\n"
+                 "  --dump-frames <dir>   write every completed frame to directory\n"
+                 "  --dump-format <name>  ppm ( default ) or png\n"
+                 "  --record <file>       record video, .gif or y4m for other extensions\n";
+}
+
+options parse(int argc, char *argv[])
+{
+    options result;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view const arg{argv[i]};
+
+        auto value = [&]() -> char const * {
+            if (i + 1 >= argc)
+                throw std::runtime_error("Missing value for " + std::string{arg} + "\n");
+            return argv[++i];
+        };
+
+        if (arg == "--frames")
+            result.frames = to_number(arg, value());
+        else if (arg == "--cycles")
+            result.cycles = to_number(arg, value());
+        else if (arg == "--run-ahead")
+            result.run_ahead = static_cast<uint32_t>(to_number(arg, value(), std::numeric_limits<uint32_t>::max()));
+        else if (arg == "--renderer")
+        {
+            std::string_view const name{value()};
+            if (name == "scanline")
+                result.line_renderer = renderer::SCANLINE;
+            else if (name == "fifo")
+                result.line_renderer = renderer::FIFO;
+            else if (name == "threaded")
+                result.line_renderer = renderer::THREADED;
+            else
+                throw std::runtime_error("Unknown renderer: " + std::string{name} + "\n");
+        }
+        else if (arg == "--frame-skip")
+            result.frame_skip = static_cast<uint32_t>(to_number(arg, value(), std::numeric_limits<uint32_t>::max()));
+        else if (arg == "--logic-only")
+            result.frame_skip = LOGIC_ONLY;
+        else if (arg == "--boot-rom")
+            result.boot_rom_file = value();
+        else if (arg == "--movie")
+            result.movie_file = value();
+        else if (arg == "--load-state")
+            result.load_state_file = value();
+        else if (arg == "--save-state")
+            result.save_state_file = value();
+        else if (arg == "--serial")
+            result.serial = true;
+        else if (arg == "--dump-memory")
+            result.dump_memory_file = value();
+        else if (arg == "--dump-frames")
+            result.dump_frames_directory = value();
+        else if (arg == "--dump-format")
+        {
+            std::string_view const name{value()};
+            if (name == "ppm")
+                result.dump_format = image_format::PPM;
+            else if (name == "png")
+                result.dump_format = image_format::PNG;
+            else
+                throw std::runtime_error("Unknown image format: " + std::string{name} + "\n");
+        }
+        else if (arg == "--record")
+            result.record_file = value();
+        else if (arg.starts_with("--"))
+            throw std::runtime_error("Unknown option: " + std::string{arg} + "\n");
+        else
+            result.rom_file = arg;
+    }
+
+    if (result.rom_file.empty())
+        throw std::runtime_error("No rom file given\n");
+
+    return result;
+}
+
+// Nothing is shown, completed frames are counted and passed on when they are dumped or recorded
+struct headless_screen : public drawing_device
+{
+    uint64_t m_frames{};
+    std::unique_ptr<software_screen> m_dump;
+    std::unique_ptr<video_recorder> m_recorder;
+
+    void after_frame(frame_view frame) override
+    {
+        ++m_frames;
+        if (m_dump)
+            m_dump->after_frame(frame);
+        if (m_recorder)
+            m_recorder->after_frame(frame);
+    }
+};
+
+void dump_memory(dmg const &gameboy, std::filesystem::path const &file)
+{
+    std::ofstream ofs{file, std::ios_base::out | std::ios_base::binary};
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open file: " + file.string() + "\n");
+
+    for (uint32_t addr = 0; addr <= 0xFFFF; ++addr)
+        ofs.put(static_cast<char>(gameboy.peek(addr)));
+}
+
+void report(dmg const &gameboy, headless_screen const &screen, double seconds)
+{
+    double const frames = static_cast<double>(gameboy.dots()) / DOTS_PER_FRAME;
+    double const emulated_seconds = static_cast<double>(gameboy.dots()) / DOTS_PER_SECOND;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "cycles:         " << gameboy.dots() << '\n';
+    std::cout << "frames:         " << frames << " ( " << screen.m_frames << " drawn )\n";
+    std::cout << "instructions:   " << gameboy.instructions() << '\n';
+    std::cout << "wall time:      " << seconds << " s\n";
+    std::cout << "frames/s:       " << frames / seconds << '\n';
+    std::cout << "instructions/s: " << gameboy.instructions() / seconds << '\n';
+    std::cout << "speed:          " << emulated_seconds / seconds << "x real time\n";
+    if (screen.m_recorder)
+        std::cout << "recorded:       " << screen.m_recorder->recorded_frames() << " frames ( "
+                  << screen.m_recorder->dropped_frames() << " dropped )\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    options opt;
+    try
+    {
+        opt = parse(argc, argv);
+    }
+    catch (std::exception const &e)
+    {
+        std::cerr << e.what();
+        usage();
+        return 1;
+    }
+
+    try
+    {
+        headless_screen screen;
+        if (!opt.dump_frames_directory.empty())
+            screen.m_dump = std::make_unique<software_screen>(opt.dump_frames_directory, opt.dump_format);
+        if (!opt.record_file.empty())
+            screen.m_recorder = std::make_unique<video_recorder>(
+                opt.record_file, opt.record_file.extension() == ".gif" ? video_format::GIF : video_format::Y4M);
+        boot_mode const mode = opt.boot_rom_file.empty() ? boot_mode::SKIP : boot_mode::BOOT_ROM;
+        dmg gameboy{opt.rom_file, screen, mode, opt.boot_rom_file};
+        gameboy.set_renderer(opt.line_renderer);
+        gameboy.set_frame_skip(opt.frame_skip);
+
+        movie const input{opt.movie_file.empty() ? movie{} : load_movie(opt.movie_file)};
+
+        if (!opt.load_state_file.empty())
+            gameboy.load_state(opt.load_state_file);
+
+        auto const start = std::chrono::steady_clock::now();
+        if (opt.cycles)
+            gameboy.run_dots(*opt.cycles);
+        else
+            play_movie(gameboy, input, opt.frames, opt.run_ahead);
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+        if (!opt.save_state_file.empty())
+            gameboy.save_state(opt.save_state_file);
+
+        if (opt.serial)
+            std::cout << gameboy.serial_output() << '\n';
+
+        if (!opt.dump_memory_file.empty())
+            dump_memory(gameboy, opt.dump_memory_file);
+
+        if (screen.m_recorder)
+            screen.m_recorder->finish();
+
+        report(gameboy, screen, elapsed.count());
+    }
+    catch (std::exception const &e)
+    {
+        std::cerr << e.what();
+        return 1;
+    }
+    return 0;
+}
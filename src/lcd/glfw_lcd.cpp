@@ -0,0 +1,212 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <lcd.hpp>
+#include <stdexcept>
+#include <string>
+
+// GLFW window for Linux, whole frame is one texture upload and one quad
+// Runs with Mesa software rasterizer too: LIBGL_ALWAYS_SOFTWARE=1
+
+namespace
+{
+
+GLFWwindow *window;
+unsigned texture;
+
+std::function<void()> quit_button_cb;
+std::function<void(key_action, key)> keyboard_button_cb;
+
+unsigned const PIXEL_SIZE = 6;
+
+// Quad over the whole viewport, texture row 0 is the top line of the screen
+const char *vertexShaderSource = "#version 330 core\n"
+                                 "layout (location = 0) in vec2 aPos;\n"
+                                 "out vec2 texCoord;\n"
+                                 "void main()\n"
+                                 "{\n"
+                                 "   texCoord = vec2((aPos.x + 1.0) / 2.0, (1.0 - aPos.y) / 2.0);\n"
+                                 "   gl_Position = vec4(aPos, 0.0, 1.0);\n"
+                                 "}\0";
+const char *fragmentShaderSource = "#version 330 core\n"
+                                   "in vec2 texCoord;\n"
+                                   "uniform sampler2D screen;\n"
+                                   "out vec4 FragColor;\n"
+                                   "void main()\n"
+                                   "{\n"
+                                   "   FragColor = texture(screen, texCoord);\n"
+                                   "}\n\0";
+
+float const vertices[] = {
+    -1.f, 1.f,  // top left
+    -1.f, -1.f, // bottom left
+    1.f,  1.f,  // top right
+    1.f,  -1.f  // bottom right
+};
+
+unsigned compile_shader(GLenum type, char const *source)
+{
+    unsigned const shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+    int success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        char infoLog[512];
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        throw std::runtime_error("Shader compilation failed: " + std::string{infoLog} + "\n");
+    }
+    return shader;
+}
+
+void init_opengl_components()
+{
+    unsigned const vertexShader = compile_shader(GL_VERTEX_SHADER, vertexShaderSource);
+    unsigned const fragmentShader = compile_shader(GL_FRAGMENT_SHADER, fragmentShaderSource);
+    unsigned const shaderProgram = glCreateProgram();
+    glAttachShader(shaderProgram, vertexShader);
+    glAttachShader(shaderProgram, fragmentShader);
+    glLinkProgram(shaderProgram);
+    int success;
+    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        char infoLog[512];
+        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+        throw std::runtime_error("Shader linking failed: " + std::string{infoLog} + "\n");
+    }
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    unsigned VBO, VAO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+    glEnableVertexAttribArray(0);
+    glUseProgram(shaderProgram);
+
+    // Storage once, frames only replace its content
+    // color is R, G, B, A in memory, rows are not padded
+    glGenTextures(1, &texture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, SCREEN_WIDTH, SCREEN_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glUniform1i(glGetUniformLocation(shaderProgram, "screen"), 0);
+
+    glClearColor(0.f, 0.f, 0.f, 1.f);
+}
+
+// Largest whole multiple of 160x144 in the middle of the window, smaller window gets what fits
+void set_viewport(int width, int height)
+{
+    int const scale = std::min(width / static_cast<int>(SCREEN_WIDTH), height / static_cast<int>(SCREEN_HEIGHT));
+    int const w = scale > 0 ? scale * static_cast<int>(SCREEN_WIDTH) : width;
+    int const h = scale > 0 ? scale * static_cast<int>(SCREEN_HEIGHT) : height;
+    glViewport((width - w) / 2, (height - h) / 2, w, h);
+}
+
+void key_callback(GLFWwindow *w, int glfw_key, int, int action, int)
+{
+    if (action == GLFW_REPEAT)
+        return;
+    key_action const a = action == GLFW_PRESS ? key_action::down : key_action::up;
+
+    switch (glfw_key)
+    {
+    case GLFW_KEY_ESCAPE:
+        glfwSetWindowShouldClose(w, GLFW_TRUE);
+        break;
+    case GLFW_KEY_LEFT:
+        std::invoke(keyboard_button_cb, a, key::LEFT);
+        break;
+    case GLFW_KEY_RIGHT:
+        std::invoke(keyboard_button_cb, a, key::RIGHT);
+        break;
+    case GLFW_KEY_UP:
+        std::invoke(keyboard_button_cb, a, key::UP);
+        break;
+    case GLFW_KEY_DOWN:
+        std::invoke(keyboard_button_cb, a, key::DOWN);
+        break;
+    case GLFW_KEY_A:
+        std::invoke(keyboard_button_cb, a, key::A);
+        break;
+    case GLFW_KEY_B:
+        std::invoke(keyboard_button_cb, a, key::B);
+        break;
+    case GLFW_KEY_Q:
+        std::invoke(keyboard_button_cb, a, key::START);
+        break;
+    case GLFW_KEY_W:
+        std::invoke(keyboard_button_cb, a, key::SELECT);
+        break;
+    }
+}
+
+void framebuffer_size_callback(GLFWwindow *, int width, int height)
+{
+    set_viewport(width, height);
+}
+
+} // namespace
+
+lcd::lcd(std::function<void()> quit_cb, std::function<void(key_action, key)> keyboard_cb)
+{
+    quit_button_cb = quit_cb;
+    keyboard_button_cb = keyboard_cb;
+
+    if (!glfwInit())
+        throw std::runtime_error("Cannot initialize GLFW\n");
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    window = glfwCreateWindow(SCREEN_WIDTH * PIXEL_SIZE, SCREEN_HEIGHT * PIXEL_SIZE, "Gameboy (DMG) Emulator. SM.", nullptr,
+                              nullptr);
+    if (!window)
+    {
+        glfwTerminate();
+        throw std::runtime_error("Cannot create window\n");
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+        throw std::runtime_error("Failed to initialize Glad\n");
+
+    init_opengl_components();
+
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);
+    set_viewport(width, height);
+}
+
+lcd::~lcd()
+{
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+void lcd::after_frame(frame_view frame)
+{
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, frame.data());
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glfwSwapBuffers(window);
+
+    glfwPollEvents();
+    if (glfwWindowShouldClose(window))
+        quit_button_cb();
+}
@@ -311,9 +311,11 @@ lcd::lcd(std::function<void()> quit_cb, std::function<void(key_action, key)> key
     CreateWindow(wc.lpszClassName, nullptr, WS_CHILDWINDOW | WS_VISIBLE, 0, 0, SCR_WIDTH, SCR_HEIGHT, main_hwnd, nullptr, hInstance, nullptr);
 }
 
+lcd::~lcd() = default;
+
 void lcd::draw_pixel(int x, int y, color c)
 {
-    glm::vec3 v{c.R, c.G, c.B};
+    glm::vec3 v{color_red(c) / 255.f, color_green(c) / 255.f, color_blue(c) / 255.f};
     glm::mat4 transform = glm::mat4(1.0f);
     transform = glm::translate(transform, glm::vec3(PIXEL_SIZE * x, PIXEL_SIZE * y, 0.0f));
     glUniformMatrix4fv(transform_loc, 1, GL_FALSE, glm::value_ptr(transform));
@@ -321,24 +323,12 @@ void lcd::draw_pixel(int x, int y, color c)
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 }
 
-void lcd::push_pixel(color c)
+void lcd::after_frame(frame_view frame)
 {
-    static int x{};
-    static int y{};
-
-    draw_pixel(x, y, c);
-    ++x;
-    if (x == 160)
-    {
-        x = 0;
-        ++y;
-        if (y == 144)
-            y = 0;
-    }
-}
+    for (int y = 0; y < SCREEN_HEIGHT; ++y)
+        for (int x = 0; x < SCREEN_WIDTH; ++x)
+            draw_pixel(x, y, frame[y * SCREEN_WIDTH + x]);
 
-void lcd::after_frame()
-{
     MSG msg{};
     while (::PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
     {
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <lcd.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// Opens real window, needs a display ( xvfb-run ) and OpenGL 3.3 ( LIBGL_ALWAYS_SOFTWARE=1 is enough )
+
+namespace
+{
+
+constexpr int WIDTH{SCREEN_WIDTH};
+constexpr int HEIGHT{SCREEN_HEIGHT};
+
+// shades in 8x8 checks, corners get own colors, so flip, shift or swapped channels show
+std::vector<color> test_frame(size_t first_shade)
+{
+    std::vector<color> frame(SCREEN_WIDTH * SCREEN_HEIGHT);
+    for (size_t y = 0; y < SCREEN_HEIGHT; ++y)
+        for (size_t x = 0; x < SCREEN_WIDTH; ++x)
+            frame[y * SCREEN_WIDTH + x] = SCREEN_SHADES[(first_shade + x / 8 + y / 8) % 4];
+    frame.front() = make_color(255, 0, 0);
+    frame[SCREEN_WIDTH - 1] = make_color(0, 255, 0);
+    frame[SCREEN_WIDTH * (SCREEN_HEIGHT - 1)] = make_color(0, 0, 255);
+    frame.back() = make_color(255, 255, 0);
+    return frame;
+}
+
+// Shown frame read back from the window, pixel in the middle of every scaled screen pixel
+std::vector<color> shown_frame()
+{
+    int width, height;
+    glfwGetFramebufferSize(glfwGetCurrentContext(), &width, &height);
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    glReadBuffer(GL_FRONT);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    EXPECT_EQ(glGetError(), static_cast<GLenum>(GL_NO_ERROR));
+
+    // whole multiple of the screen in the middle of the window, rows of OpenGL go from the bottom
+    int const scale = std::min(width / WIDTH, height / HEIGHT);
+    EXPECT_GE(scale, 1);
+    int const left = (width - scale * WIDTH) / 2;
+    int const bottom = (height - scale * HEIGHT) / 2;
+
+    std::vector<color> result(SCREEN_WIDTH * SCREEN_HEIGHT);
+    for (int y = 0; y < HEIGHT; ++y)
+        for (int x = 0; x < WIDTH; ++x)
+        {
+            size_t const gl_x = left + x * scale + scale / 2;
+            size_t const gl_y = bottom + (HEIGHT - 1 - y) * scale + scale / 2;
+            uint8_t const *p = &pixels[(gl_y * width + gl_x) * 4];
+            result[y * WIDTH + x] = make_color(p[0], p[1], p[2]);
+        }
+    return result;
+}
+
+} // namespace
+
+TEST(glfw_lcd_tests, presented_frame_is_shown_whole)
+{
+    bool quit{};
+    lcd screen{[&quit]() { quit = true; }, [](key_action, key) {}};
+
+    // second frame only replaces content of the texture
+    auto const first = test_frame(0);
+    auto const second = test_frame(1);
+    screen.after_frame(frame_view{first.data(), first.size()});
+    screen.after_frame(frame_view{second.data(), second.size()});
+    ASSERT_FALSE(quit);
+
+    auto const shown = shown_frame();
+    for (size_t i = 0; i < shown.size(); ++i)
+        ASSERT_EQ(shown[i], second[i]) << "x " << i % SCREEN_WIDTH << " y " << i / SCREEN_WIDTH;
+}
+
+TEST(glfw_lcd_tests, closed_window_quits)
+{
+    bool quit{};
+    lcd screen{[&quit]() { quit = true; }, [](key_action, key) {}};
+    auto const frame = test_frame(0);
+
+    screen.after_frame(frame_view{frame.data(), frame.size()});
+    ASSERT_FALSE(quit);
+    glfwSetWindowShouldClose(glfwGetCurrentContext(), GLFW_TRUE);
+    screen.after_frame(frame_view{frame.data(), frame.size()});
+    ASSERT_TRUE(quit);
+}
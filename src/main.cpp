@@ -1,192 +1,103 @@
-#include <cpu.hpp>
-#include <ppu.hpp>
+#include <command_line.hpp>
+#include <dmg.hpp>
+#include <frame_exchange.hpp>
 #include <lcd.hpp>
-#include "mem.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace
 {
 
-enum class Joypad
-{
-    BUTTONS,
-    INPUT,
-    ALL
-} joypad_mode = Joypad::ALL;
-
-bool quit{};
+std::atomic<bool> quit{};
 void quit_cb()
 {
     quit = true;
 }
 
-uint8_t joypad_buttons{0xFF};
-uint8_t joypad_input{0xFF};
-
-memory *ptr;
+// Keys come from the window thread, machine takes them at the start of its next frame
+std::mutex key_mutex;
+std::vector<std::pair<key_action, key>> pending_keys;
 
 void keyboard_cb(key_action a, key k)
 {
-    if (a == key_action::down) // press
-    {
-        if (k == key::RIGHT)
-            clearbit(joypad_input, 0);
-        if (k == key::LEFT)
-            clearbit(joypad_input, 1);
-        if (k == key::UP)
-            clearbit(joypad_input, 2);
-        if (k == key::DOWN)
-            clearbit(joypad_input, 3);
-
-        if (k == key::A)
-            clearbit(joypad_buttons, 0);
-        if (k == key::B)
-            clearbit(joypad_buttons, 1);
-        if (k == key::SELECT)
-            clearbit(joypad_buttons, 2);
-        if (k == key::START)
-            clearbit(joypad_buttons, 3);
+    std::lock_guard lock{key_mutex};
+    pending_keys.emplace_back(a, k);
+}
 
-        // Joypad INT
-        uint8_t IF = ptr->read(0xFF0F);
-        setbit(IF, 4);
-        ptr->write(0xFF0F, IF);
-    }
-    else
+// Real hardware frame rate, machine sleeps for the rest of the frame
+// When it falls behind, it continues from now instead of running a burst of frames
+void emulate(dmg &gameboy, uint32_t run_ahead)
+{
+    std::chrono::nanoseconds const frame_time{uint64_t{DOTS_PER_FRAME} * 1'000'000'000 / DOTS_PER_SECOND};
+    std::vector<std::pair<key_action, key>> keys;
+    auto next_frame = std::chrono::steady_clock::now();
+    while (!quit)
     {
-        if (k == key::RIGHT)
-            setbit(joypad_input, 0);
-        if (k == key::LEFT)
-            setbit(joypad_input, 1);
-        if (k == key::UP)
-            setbit(joypad_input, 2);
-        if (k == key::DOWN)
-            setbit(joypad_input, 3);
+        {
+            std::lock_guard lock{key_mutex};
+            keys.swap(pending_keys);
+        }
+        for (auto const &[a, k] : keys)
+            gameboy.key_event(a, k);
+        keys.clear();
 
-        if (k == key::A)
-            setbit(joypad_buttons, 0);
-        if (k == key::B)
-            setbit(joypad_buttons, 1);
-        if (k == key::SELECT)
-            setbit(joypad_buttons, 2);
-        if (k == key::START)
-            setbit(joypad_buttons, 3);
-    }
-}
+        gameboy.run_frame_ahead(run_ahead);
 
-void cpu_callback(registers const &regs, opcode const &op)
-{
+        next_frame += frame_time;
+        auto const now = std::chrono::steady_clock::now();
+        if (next_frame < now)
+            next_frame = now;
+        std::this_thread::sleep_until(next_frame);
+    }
 }
 
-// for debugging
-registers get_start_values()
-{
-    registers sv;
-    sv.A() = 1;
-    sv.F() = 0xB0;
-    sv.B() = 0;
-    sv.C() = 0x13;
-    sv.D() = 0;
-    sv.E() = 0xD8;
-    sv.H() = 1;
-    sv.L() = 0x4D;
-    sv.SP() = 0xFFFE;
-    sv.PC() = 0x0100;
-    return sv;
-}
+} // namespace
 
-struct dmg : public rw_device
+int main(int argc, char *argv[])
 {
-    memory m_mem;
-    lcd m_lcd;
-    cpu m_cpu;
-    ppu m_ppu;
-
-    dmg() : m_lcd{quit_cb, keyboard_cb}, m_cpu{*this, cpu_callback}, m_ppu{*this, m_lcd}
+    std::filesystem::path const rom_file{argc > 1 ? argv[1] : ROM_FILE};
+    // frames to run ahead, hides input lag of the game
+    uint32_t run_ahead{};
+    try
     {
-        ptr = &m_mem;
+        if (argc > 2)
+            run_ahead = static_cast<uint32_t>(to_number("run ahead", argv[2], std::numeric_limits<uint32_t>::max()));
     }
-
-    uint8_t read(uint16_t addr, device d, bool direct) override
+    catch (std::exception const &e)
     {
-        if (d == device::PPU)
-            m_cpu.tick();
-
-        if (addr == 0xFF00)
-        {
-            // 1 - is not pressed
-            // 0 - is pressed
-            switch (joypad_mode)
-            {
-            case Joypad::ALL:
-                return 0xFF;
-            case Joypad::BUTTONS: {
-                if ((joypad_buttons & 0x03) < 7)
-                    m_cpu.resume();
-                return joypad_buttons;
-            }
-            case Joypad::INPUT:
-                if ((joypad_buttons & 0x03) < 7)
-                    m_cpu.resume();
-                return joypad_input;
-            }
-        }
-
-        return m_mem.read(addr, d);
-    }
-
-    void write(uint16_t addr, uint8_t data, device d, bool direct) override
-    {
-        // Joypad
-        if (addr == 0xFF00)
-        {
-            if (!checkbit(data, 5))
-                joypad_mode = Joypad::BUTTONS;
-            else if (!checkbit(data, 4))
-                joypad_mode = Joypad::INPUT;
-            else if (checkbit(data, 5) && checkbit(data, 4))
-                joypad_mode = Joypad::ALL;
-        }
-
-        // Divider register, any value resets its value to 0x00
-        // Normal CPU update of this registry is with flag "direct"
-        if (addr == 0xFF04 && !direct)
-        {
-            m_mem.write(0xFF04, 0);
-            return;
-        }
-
-        // DMA
-        if (addr == 0xFF46 && d == device::CPU)
-        {
-            m_ppu.dma(data);
-            return;
-        }
-
-        m_mem.write(addr, data, d);
+        std::cerr << e.what();
+        return 1;
     }
 
-    void loop()
+    // Machine runs on its own thread, window shows the newest completed frame,
+    // so slow swap of the window does not stall emulation
+    lcd screen{quit_cb, keyboard_cb};
+    frame_exchange frames;
+    auto const gameboy = std::make_unique<dmg>(rom_file, frames, boot_mode::BOOT_ROM, BOOT_ROM_FILE);
+    std::thread emulation{emulate, std::ref(*gameboy), run_ahead};
+
+    // Window polls its events in after_frame, so it is called also when no new frame comes ( LCD off ),
+    // then the last frame is drawn again after a short sleep
+    std::array<color, SCREEN_WIDTH * SCREEN_HEIGHT> blank;
+    blank.fill(SCREEN_SHADES[0]);
+    frame_view shown{blank};
+    while (!quit)
     {
-        int cc{4};
-        while (!quit)
-        {
-            // 1 CPU tick == 4 PPU dots
-            m_ppu.dot();
-            --cc;
-            if (!cc)
-            {
-                m_cpu.tick();
-                cc = 4;
-            }
-        }
+        if (auto const frame = frames.take_frame())
+            shown = *frame;
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+        screen.after_frame(shown);
     }
-};
-
-} // namespace
 
-int main()
-{
-    dmg gameboy;
-    gameboy.loop();
+    emulation.join();
     return 0;
-}
\ No newline at end of file
+}
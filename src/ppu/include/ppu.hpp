@@ -1,10 +1,12 @@
 #ifndef PPU_HPP
 #define PPU_HPP
 
+#include <common.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-
-struct rw_device;
-struct drawing_device;
+#include <span>
 
 enum class STATE
 {
@@ -14,6 +16,200 @@ enum class STATE
     VERTICAL_BLANK
 };
 
+enum class renderer
+{
+    FIFO,    // pixel per dot through pixel fifo, for accuracy work
+    SCANLINE, // whole line at the start of HBlank, same output and timing, unchanged lines are not drawn again
+    THREADED  // scanline renderer on its own thread, lines are reported together before the frame
+};
+
+// Frame skip which never draws, ppu keeps only its timing
+constexpr uint32_t LOGIC_ONLY{UINT32_MAX};
+
+// Pixel in fifo, 1 byte
+constexpr uint8_t PIXEL_COLOR_ID{0x03}; // 0-3, 0 means transparent for sprite
+constexpr uint8_t PIXEL_PALETTE{0x04};  // OBP0 or OBP1
+constexpr uint8_t PIXEL_PRIORITY{0x08}; // BG and window colors 1-3 are drawn over this sprite pixel
+constexpr uint8_t PIXEL_SPRITE{0x80};   // sprite pixel, otherwise BG / window
+
+// Ring of pixels, plain data so it is saved with the rest of ppu state
+struct pixel_fifo
+{
+    static constexpr uint8_t CAPACITY{16};
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "capacity is power of two");
+
+    std::array<uint8_t, CAPACITY> m_pixels{};
+    uint8_t m_head{};
+    uint8_t m_size{};
+
+    uint8_t size() const
+    {
+        return m_size;
+    }
+
+    void push_back(uint8_t pixel)
+    {
+        m_pixels[(m_head + m_size++) & (CAPACITY - 1)] = pixel;
+    }
+
+    uint8_t pop_front()
+    {
+        uint8_t const pixel = m_pixels[m_head];
+        m_head = (m_head + 1) & (CAPACITY - 1);
+        --m_size;
+        return pixel;
+    }
+
+    uint8_t &operator[](uint8_t i)
+    {
+        return m_pixels[(m_head + i) & (CAPACITY - 1)];
+    }
+
+    void clear()
+    {
+        m_head = m_size = 0;
+    }
+};
+
+// 0xFF40-0xFF4B as ppu sees them, with values derived from LCDC
+// Updated on reported writes, renderers read it instead of the bus, fits one cache line
+struct alignas(64) ppu_registers
+{
+    uint8_t m_lcdc{};
+    uint8_t m_stat{};
+    uint8_t m_scy{};
+    uint8_t m_scx{};
+    uint8_t m_ly{};
+    uint8_t m_lyc{};
+    uint8_t m_dma{};
+    uint8_t m_bgp{};
+    uint8_t m_obp0{};
+    uint8_t m_obp1{};
+    uint8_t m_wy{};
+    uint8_t m_wx{};
+
+    // derived from LCDC when it is written
+    uint16_t m_background_map_addr{0x9800};
+    uint16_t m_window_map_addr{0x9800};
+    bool m_signed_tile_index{true}; // tiles 0x8800-0x97FF, index is signed and 0 is at 0x9000
+    uint8_t m_sprite_height{8};
+
+    // rest of the cache line, explicit so saved bytes are always the same
+    std::array<uint8_t, 46> m_unused{};
+
+    bool operator==(ppu_registers const &) const = default;
+
+    // CPU write, STAT keeps its read only bits and LY is not written at all
+    void write(uint16_t addr, uint8_t value);
+
+    // First byte of background / window tile
+    uint16_t tile_addr(uint8_t tile_index) const
+    {
+        return m_signed_tile_index ? 0x9000 + static_cast<int8_t>(tile_index) * 16 : 0x8000 + tile_index * 16;
+    }
+};
+static_assert(sizeof(ppu_registers) == 64);
+
+// OAM as struct of arrays, updated on every write to 0xFE00-0xFE9F
+// Arrays are padded to 48 entries so they can be compared 16 at a time, padding never matches a line
+struct oam_mirror
+{
+    static constexpr uint16_t OAM_ADDR{0xFE00};
+    static constexpr size_t SPRITES{40};
+    static constexpr size_t PADDED{48};
+    static constexpr size_t OAM_SIZE{SPRITES * 4};
+
+    std::array<uint8_t, PADDED> m_y{};
+    std::array<uint8_t, PADDED> m_x{};
+    std::array<uint8_t, PADDED> m_tile{};
+    std::array<uint8_t, PADDED> m_flags{};
+
+    void write(uint16_t addr, uint8_t value)
+    {
+        size_t const i = (addr - OAM_ADDR) / 4;
+        switch ((addr - OAM_ADDR) % 4)
+        {
+        case 0:
+            m_y[i] = value;
+            break;
+        case 1:
+            m_x[i] = value;
+            break;
+        case 2:
+            m_tile[i] = value;
+            break;
+        case 3:
+            m_flags[i] = value;
+            break;
+        }
+    }
+
+    void load(std::span<uint8_t const, OAM_SIZE> oam)
+    {
+        for (size_t i = 0; i < SPRITES; ++i)
+        {
+            m_y[i] = oam[i * 4];
+            m_x[i] = oam[i * 4 + 1];
+            m_tile[i] = oam[i * 4 + 2];
+            m_flags[i] = oam[i * 4 + 3];
+        }
+    }
+
+    sprite get(size_t i) const
+    {
+        return sprite{m_y[i], m_x[i], m_tile[i], m_flags[i]};
+    }
+};
+
+// Plain data, save states copy it as a whole
+// Padding is explicit, otherwise ppu_impl members may be placed in it and get saved too
+struct ppu_state
+{
+    ppu_registers m_registers;
+
+    STATE m_current_state{STATE::OAM_SCAN};
+    int m_current_dot{};  // 0-455 in line
+    int m_current_line{}; // LY
+    int m_next_event_dot{};
+
+    // frame skip is decided at the start of each frame, frames skipped since the last drawn one are counted
+    uint32_t m_skipped_frames{};
+    bool m_skip_frame{};
+
+    // renderer has pushed the whole line in current mode 3
+    bool m_line_drawn{};
+
+    // interrupt is raised when any enabled STAT source goes on
+    bool m_stat_line{};
+
+    oam_mirror m_oam;
+
+    // temporary value of visible sprites in each drawing line
+    std::array<sprite, 10> m_visible_sprites{};
+    uint8_t m_visible_sprites_count{};
+
+    // state of currently drawn line
+    uint8_t m_current_x{};
+    uint8_t m_scroll_x{};
+    uint8_t m_scroll_y{};
+    uint8_t m_pixel_count_to_discard{};
+    uint8_t m_pushed_pixels{};
+
+    // window is shown from the line where LY == WY, lines are counted only when it is drawn
+    bool m_window_y_triggered{};
+    bool m_window_on_line{};
+    bool m_window_active{}; // fifo fetches window tiles
+    uint8_t m_window_line{};
+    uint8_t m_window_tile{};
+
+    // sprite fifo covers the next 8 pixels of background fifo
+    pixel_fifo m_background_fifo;
+    pixel_fifo m_sprite_fifo;
+
+    // up to the alignment of registers
+    std::array<uint8_t, 18> m_unused{};
+};
+
 class ppu
 {
   public:
@@ -22,9 +218,42 @@ class ppu
 
     void dot();
 
-    // src_addr can be 0x00 to 0xDF
-    void dma(uint8_t src_addr);
     STATE current_state() const;
+
+    // Every write to 0x8000-0x9FFF has to be reported, decoded tiles are cached
+    void vram_written(uint16_t addr);
+
+    // Every write to 0xFE00-0xFE9F has to be reported
+    void oam_written(uint16_t addr, uint8_t value);
+
+    // OAM DMA is done by the caller as one copy, whole new OAM is reported at once
+    void oam_dma(std::span<uint8_t const, oam_mirror::OAM_SIZE> oam);
+
+    // Every CPU write to 0xFF40-0xFF4B has to be reported with the stored value, ppu keeps its copy
+    // LY and read only STAT bits are restored in memory
+    void register_written(uint16_t addr, uint8_t value);
+
+    // Buffer has to outlive ppu, by default ppu draws into its own
+    // THREADED renderer writes it on its thread, pixels are complete only in drawing device calls
+    void set_frame_buffer(frame_buffer buffer);
+    frame_buffer current_frame_buffer() const;
+
+    // Buffer was drawn by someone else, e.g. run-ahead machine, lines are drawn again instead of being reused
+    // Waits for lines queued to THREADED renderer, so the other one can draw after it
+    void frame_buffer_changed();
+
+    void set_renderer(renderer r);
+    renderer current_renderer() const;
+
+    // After every drawn frame given number of frames is skipped, LOGIC_ONLY skips all
+    // Skipped frame keeps LY, STAT, interrupts and mode 3 length, but nothing is fetched or drawn
+    // and drawing device is not called, change applies from the next frame, LOGIC_ONLY at once
+    void set_frame_skip(uint32_t frames);
+    uint32_t frame_skip() const;
+
+    ppu_state save_state() const;
+    void load_state(ppu_state const &state);
+
     struct ppu_impl;
 
   private:
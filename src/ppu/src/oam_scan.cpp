@@ -0,0 +1,55 @@
+#include "oam_scan.hpp"
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define OAM_SCAN_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+// y - 16 <= line < y - 16 + height, in 8 bit arithmetic as the PPU does it
+bool covers(uint8_t y, uint8_t line, uint8_t height)
+{
+    return static_cast<uint8_t>(line + 16 - y) < height;
+}
+
+} // namespace
+
+uint8_t select_sprites_scalar(oam_mirror const &oam, uint8_t line, uint8_t height, std::array<sprite, 10> &out)
+{
+    uint8_t count = 0;
+    for (size_t i = 0; i < oam_mirror::SPRITES && count < out.size(); ++i)
+    {
+        if (covers(oam.m_y[i], line, height))
+            out[count++] = oam.get(i);
+    }
+    return count;
+}
+
+uint8_t select_sprites(oam_mirror const &oam, uint8_t line, uint8_t height, std::array<sprite, 10> &out)
+{
+#if defined(OAM_SCAN_SSE2)
+    // line + 16 - y < height, unsigned compare through min
+    __m128i const top = _mm_set1_epi8(static_cast<char>(line + 16));
+    __m128i const last = _mm_set1_epi8(static_cast<char>(height - 1));
+    uint64_t mask = 0;
+    for (size_t i = 0; i < oam_mirror::PADDED; i += 16)
+    {
+        __m128i const y = _mm_loadu_si128(reinterpret_cast<__m128i const *>(oam.m_y.data() + i));
+        __m128i const diff = _mm_sub_epi8(top, y);
+        __m128i const hit = _mm_cmpeq_epi8(_mm_min_epu8(diff, last), diff);
+        mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(hit))) << i;
+    }
+    // padding has y 0 and is never hit, only sprites are left
+    mask &= (uint64_t{1} << oam_mirror::SPRITES) - 1;
+
+    uint8_t count = 0;
+    for (; mask && count < out.size(); mask &= mask - 1)
+        out[count++] = oam.get(std::countr_zero(mask));
+    return count;
+#else
+    return select_sprites_scalar(oam, line, height, out);
+#endif
+}
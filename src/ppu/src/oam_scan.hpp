@@ -0,0 +1,16 @@
+#ifndef OAM_SCAN_HPP
+#define OAM_SCAN_HPP
+
+#include <ppu.hpp>
+#include <array>
+#include <cstdint>
+
+// Up to 10 sprites which cover given line, in OAM order, returns their count
+// Sprite covers lines y - 16 to y - 16 + height - 1
+// Y positions are compared 16 at a time when the build allows SSE2
+uint8_t select_sprites(oam_mirror const &oam, uint8_t line, uint8_t height, std::array<sprite, 10> &out);
+
+// One sprite at a time, for tests
+uint8_t select_sprites_scalar(oam_mirror const &oam, uint8_t line, uint8_t height, std::array<sprite, 10> &out);
+
+#endif
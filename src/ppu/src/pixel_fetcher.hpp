@@ -2,16 +2,27 @@
 #define PIXEL_FETCHER_HPP
 
 #include <common.hpp>
+#include <cstddef>
+#include <ppu.hpp>
 
 class pixel_fetcher
 {
   public:
-    explicit pixel_fetcher(rw_device &rw_device);
-    uint16_t fetch_tile_line(screen_coordinates sc);
-    void update_addresses();
+    // Addresses are derived from LCDC copy in ppu state
+    pixel_fetcher(rw_device &rw_device, ppu_state &state);
+    // Address of tile line under given coordinates, its pixels come from tile cache
+    uint16_t fetch_tile_line_addr(screen_coordinates sc);
+    // The same in window map, coordinates are inside window
+    uint16_t fetch_window_line_addr(screen_coordinates sc);
 
   private:
     rw_device &m_rw;
+    ppu_state &m_state;
+
+    uint16_t get_background_addr(size_t tile_map_index);
+    uint16_t get_window_addr(size_t tile_map_index);
+    uint16_t get_background(screen_coordinates sc);
+    uint16_t get_window(screen_coordinates sc);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,66 +1,16 @@
 #include "ppu_impl.hpp"
 #include <array>
 #include <cassert>
-#include <deque>
-#include <variant>
 
-namespace
+std::array<color, 4> make_palette_colors(uint8_t palette)
 {
-
-constexpr color WHITE{1.f, 1.f, 1.f};
-constexpr color LIGHT_GRAY{0.867f, 0.706f, 0.71f};
-constexpr color DARK_GRAY{0.38f, 0.31f, 0.302f};
-constexpr color BLACK{};
-
-std::array<color, 4> VALUE_COLOR_MAP{WHITE, LIGHT_GRAY, DARK_GRAY, BLACK};
-
-color get_color(uint8_t color_id, uint8_t palette)
-{
-    switch (color_id)
-    {
-    case 0:
-        return VALUE_COLOR_MAP[palette & 0x03];
-    case 1:
-        return VALUE_COLOR_MAP[palette >> 2 & 0x03];
-    case 2:
-        return VALUE_COLOR_MAP[palette >> 4 & 0x03];
-    case 3:
-        return VALUE_COLOR_MAP[palette >> 6 & 0x03];
-    default:
-        assert(false);
-    }
+    // 2 bits per color id, id 0 in lowest bits
+    std::array<color, 4> result{};
+    for (uint8_t id = 0; id < 4; ++id)
+        result[id] = SCREEN_SHADES[(palette >> (id * 2)) & 0x03];
+    return result;
 }
 
-struct sprite_pixel
-{
-    uint8_t m_priority{};   // 0 or 1 ( BG and Window colors 1–3 are drawn over this OBJ )
-    uint8_t m_color_id{};   // 0-3, 0 means transparent
-    uint8_t m_palette_id{}; // 0 or 1
-
-    color color(rw_device &rw) const
-    {
-        assert(m_color_id != 0);
-        uint8_t palette{};
-        if (m_palette_id == 0)
-            palette = rw.read(0xFF48, device::PPU);
-        else
-            palette = rw.read(0xFF49, device::PPU);
-        return get_color(m_color_id, palette);
-    }
-};
-
-struct bgw_pixel
-{
-    uint8_t m_color_id{}; // 0-3
-
-    color color(rw_device &rw) const
-    {
-        uint8_t val{};
-        uint8_t const palette = rw.read(0xFF47, device::PPU);
-        return get_color(m_color_id, palette);
-    }
-};
-
 std::array<uint8_t, 8> convert_tile_line_to_color_ids(uint16_t line)
 {
     uint8_t const l = line >> 8; // a b c d ...
@@ -80,176 +30,108 @@ std::array<uint8_t, 8> convert_tile_line_to_color_ids(uint16_t line)
     return result;
 }
 
-uint16_t read_two_bytes(rw_device &rw, uint16_t addr)
+uint8_t mix_pixels(uint8_t background, uint8_t sprite)
 {
-    uint8_t const tile_lo = rw.read(addr, device::PPU, true);
-    uint8_t const tile_hi = rw.read(addr + 1, device::PPU, true);
-    uint16_t line = tile_hi;
-    line <<= 8;
-    line |= tile_lo;
-    return line;
+    // transparent sprite pixel, or background has priority and is not color 0
+    if ((sprite & PIXEL_COLOR_ID) == 0 || ((sprite & PIXEL_PRIORITY) && (background & PIXEL_COLOR_ID) != 0))
+        return background;
+    return sprite;
 }
 
-} // namespace
-
-namespace
+uint8_t const *ppu::ppu_impl::sprite_line(sprite const &s)
 {
-uint8_t current_x{};
-uint8_t scroll_x{};
-uint8_t scroll_y{};
-
-uint8_t pixel_count_to_discard{};
-
-uint8_t pushed_pixels{};
-
-enum pixel_type
-{
-    BACKGROUND = 0,
-    SPRITE = 1
-};
-
-using final_pixel = std::variant<bgw_pixel, sprite_pixel>;
-std::deque<final_pixel> pixel_fifo;
-
-} // namespace
-
-void ppu::ppu_impl::update_stat(STATE s)
-{
-    uint8_t STAT = m_rw_device.read(0xFF41, device::PPU, true);
-
-    // Update FF41, PPU MODE
-    if (s == STATE::OAM_SCAN)
-    {
-        setbit(STAT, 1); // mode 2
-        clearbit(STAT, 0);
-    }
-    else if (s == STATE::DRAWING_PIXELS)
-    {
-        STAT |= 0x03; // mode 3
-    }
-    else if (s == STATE::HORIZONTAL_BLANK)
-    {
-        STAT &= 0xFC; // mode 0
-    }
-    else
-    {
-        // Vertical Blank
-        setbit(STAT, 0); // mode 1
-        clearbit(STAT, 1);
-    }
-
-    m_rw_device.write(0xFF41, STAT, device::PPU, true);
-
-    if ((checkbit(STAT, 3) && (s == STATE::HORIZONTAL_BLANK)) || (checkbit(STAT, 4) && (s == STATE::VERTICAL_BLANK)) ||
-        (checkbit(STAT, 5) && (s == STATE::OAM_SCAN)))
-    {
-        STAT_INT();
-    }
+    uint8_t const sprite_top_y = s.m_y_pos - 16;
+    uint8_t const diff = m_current_line - sprite_top_y;
+    uint16_t const addr = s.line_addr(diff, m_registers.m_sprite_height);
+    return s.x_flip() ? m_tile_cache.flipped_line(addr) : m_tile_cache.line(addr);
 }
 
-void ppu::ppu_impl::STAT_INT()
+void ppu::ppu_impl::reset_line()
 {
-    uint8_t IF = m_rw_device.read(0xFF0F, device::PPU, true);
-    setbit(IF, 1);
-    m_rw_device.write(0xFF0F, IF, device::PPU, true);
+    m_pushed_pixels = m_current_x = m_scroll_x = m_scroll_y = m_pixel_count_to_discard = 0;
+    m_window_active = false;
+    m_window_tile = 0;
+    m_background_fifo.clear();
+    m_sprite_fifo.clear();
 }
 
 bool ppu::ppu_impl::draw_pixel_line()
 {
-    if (current_x == 0)
+    if (m_current_x == 0)
     {
-        scroll_x = m_rw_device.read(0xFF43, device::PPU, true);
-        scroll_y = m_rw_device.read(0xFF42, device::PPU, true);
-        pixel_count_to_discard = scroll_x % 8;
+        m_scroll_x = m_registers.m_scx;
+        m_scroll_y = m_registers.m_scy;
+        m_pixel_count_to_discard = m_scroll_x % 8;
     }
     else
-        scroll_x = m_rw_device.read(0xFF43, device::PPU, true) & 0xF8;
-
-    screen_coordinates sc{static_cast<uint8_t>(current_x + scroll_x), static_cast<uint8_t>(m_current_line + scroll_y)};
+        m_scroll_x = m_registers.m_scx & 0xF8;
 
-    if (pixel_fifo.size() <= 8)
+    // Fetcher restarts with window tiles when the next pixel is at WX - 7
+    // window pixels left of the screen ( WX < 7 ) are discarded
+    if (m_window_on_line && !m_window_active && !m_pixel_count_to_discard && m_pushed_pixels + 7 >= m_registers.m_wx)
     {
-        uint16_t background_line = m_pixel_fetcher.fetch_tile_line(sc);
-        auto const colors = convert_tile_line_to_color_ids(background_line);
-        for (auto c : colors)
-            pixel_fifo.push_back(bgw_pixel{c});
-        current_x += 8;
+        m_window_active = true;
+        m_background_fifo.clear();
+        m_pixel_count_to_discard = m_registers.m_wx < 7 ? 7 - m_registers.m_wx : 0;
     }
 
-    uint8_t const curr_window_x = m_rw_device.read(0xFF4A, device::PPU, true);
-    uint8_t const curr_window_y = m_rw_device.read(0xFF4B, device::PPU, true);
+    if (m_background_fifo.size() <= 8)
+    {
+        uint16_t const line_addr =
+            m_window_active
+                ? m_pixel_fetcher.fetch_window_line_addr({static_cast<uint8_t>(m_window_tile++ * 8), m_window_line})
+                : m_pixel_fetcher.fetch_tile_line_addr({static_cast<uint8_t>(m_current_x + m_scroll_x),
+                                                        static_cast<uint8_t>(m_current_line + m_scroll_y)});
+        uint8_t const *colors = m_tile_cache.line(line_addr);
+        for (int i = 0; i < 8; ++i)
+            m_background_fifo.push_back(colors[i]);
+        m_current_x += 8;
+    }
 
-    if (!visible_sprites.empty())
+    // sprites are mixed once, when their first pixel is the next to be pushed, not while pixels are discarded
+    if (m_visible_sprites_count && !m_pixel_count_to_discard)
     {
-        assert(pixel_fifo.size() >= 8);
-        for (auto const &vs : visible_sprites)
+        for (int s = 0; s < m_visible_sprites_count; ++s)
         {
-            if (vs.m_x_pos > 0 && ((vs.m_x_pos - 8) == pushed_pixels))
+            sprite const &vs = m_visible_sprites[s];
+            if (vs.m_x_pos > 0 && ((vs.m_x_pos - 8) == m_pushed_pixels))
             {
-                uint8_t const sprite_top_y = vs.m_y_pos - 16;
-                uint8_t const diff = m_current_line - sprite_top_y;
-                uint16_t const line_addr = vs.line_addr(diff);
-                uint16_t const sprite_line = read_two_bytes(m_rw_device, line_addr);
+                uint8_t const *sprite_line_colors = sprite_line(vs);
 
-                auto sprite_line_colors = convert_tile_line_to_color_ids(sprite_line);
+                while (m_sprite_fifo.size() < 8)
+                    m_sprite_fifo.push_back(0);
 
-                for (int i = 0; i < 8; ++i)
+                // earlier sprite keeps its pixels, only transparent ones are taken
+                uint8_t const attributes =
+                    PIXEL_SPRITE | (vs.priority() ? PIXEL_PRIORITY : 0) | (vs.palette() ? PIXEL_PALETTE : 0);
+                for (uint8_t i = 0; i < 8; ++i)
                 {
-                    if (sprite_line_colors[i] == 0) // Transparent case
-                        continue;
-
-                    switch (pixel_fifo[i].index())
-                    {
-                    case BACKGROUND: {
-                        bgw_pixel const &p = std::get<BACKGROUND>(pixel_fifo[i]);
-                        // sprite with priority 0 wins over any background pixel
-                        // sprite with priority 1 wins only over background pixel with color id 0
-                        // in other cases sprite pixel lose
-                        if (vs.priority() == 0 || (vs.priority() == 1 && p.m_color_id == 0))
-                            pixel_fifo[i] = sprite_pixel{0, sprite_line_colors[i], vs.palette()};
-                        break;
-                    }
-                    case SPRITE:
-                        // do nothing with old sprite
-                        break;
-                    default:
-                        assert(false);
-                    }
+                    if (sprite_line_colors[i] != 0 && (m_sprite_fifo[i] & PIXEL_COLOR_ID) == 0)
+                        m_sprite_fifo[i] = attributes | sprite_line_colors[i];
                 }
             }
         }
     }
 
-    if (pixel_fifo.size() >= 8)
+    assert(m_background_fifo.size() >= 8);
+    if (m_pixel_count_to_discard)
     {
-        if (pixel_count_to_discard)
-        {
-            --pixel_count_to_discard;
-            pixel_fifo.pop_front();
-            return false;
-        }
+        --m_pixel_count_to_discard;
+        m_background_fifo.pop_front();
+        return false;
+    }
 
-        if (pixel_fifo.front().index() == BACKGROUND)
-        {
-            bgw_pixel &p = std::get<BACKGROUND>(pixel_fifo.front());
-            m_drawing_device.push_pixel(p.color(m_rw_device));
-        }
-        else
-        {
-            sprite_pixel &sp = std::get<SPRITE>(pixel_fifo.front());
-            m_drawing_device.push_pixel(sp.color(m_rw_device));
-        }
+    uint8_t const background_pixel = m_background_fifo.pop_front();
+    uint8_t const sprite_pixel = m_sprite_fifo.size() ? m_sprite_fifo.pop_front() : 0;
+    uint8_t const pixel = mix_pixels(background_pixel, sprite_pixel);
 
-        pixel_fifo.pop_front();
-        ++pushed_pixels;
+    // colors follow palette writes, changes in the middle of line are visible
+    line_pixels()[m_pushed_pixels++] = m_colors[pixel_color_index(pixel)];
 
-        if (pushed_pixels == 160)
-        {
-            pushed_pixels = current_x = scroll_x = scroll_y = pixel_count_to_discard = 0;
-            std::deque<final_pixel> empty{};
-            pixel_fifo.swap(empty);
-            return true;
-        }
+    if (m_pushed_pixels == 160)
+    {
+        reset_line();
+        return true;
     }
 
     return false;
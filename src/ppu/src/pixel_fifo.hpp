@@ -0,0 +1,23 @@
+#ifndef PIXEL_FIFO_HPP
+#define PIXEL_FIFO_HPP
+
+#include <common.hpp>
+#include <ppu.hpp>
+#include <array>
+
+// 2 bytes of tile line ( hi << 8 | lo ) to 8 color ids, leftmost pixel first
+std::array<uint8_t, 8> convert_tile_line_to_color_ids(uint16_t line);
+
+// Colors of color ids 0-3 through palette register value ( BGP, OBP0, OBP1 )
+std::array<::color, 4> make_palette_colors(uint8_t palette);
+
+// Index of mixed pixel in 16 colors: BGP ones, unused, OBP0 ones, OBP1 ones
+constexpr uint8_t pixel_color_index(uint8_t pixel)
+{
+    return ((pixel & PIXEL_SPRITE) >> 4) | (pixel & (PIXEL_PALETTE | PIXEL_COLOR_ID));
+}
+
+// Pixel which is shown when background and sprite pixels meet
+uint8_t mix_pixels(uint8_t background, uint8_t sprite);
+
+#endif
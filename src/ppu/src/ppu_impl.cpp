@@ -1,85 +1,182 @@
 #include <common.hpp>
 #include "ppu_impl.hpp"
+#include <algorithm>
 #include <array>
-#include <cassert>
 #include "pixel_fetcher.hpp"
 #include "ppu.hpp"
 
 ppu::ppu_impl::ppu_impl(rw_device &rw_device, drawing_device &drawing_device)
-    : m_rw_device{rw_device}, m_drawing_device{drawing_device}, m_pixel_fetcher{rw_device}
+    : m_rw_device{rw_device}, m_drawing_device{drawing_device}, m_pixel_fetcher{rw_device, *this},
+      m_tile_cache{rw_device}
 {
+    reload_palettes();
 }
 
-void ppu::ppu_impl::dot()
+color *ppu::ppu_impl::line_pixels()
 {
-    m_lcd_ctrl = m_rw_device.read(0xFF40, device::PPU);
-
-    if (!checkbit(m_lcd_ctrl, 7))
-    {
-        m_current_dot = m_current_line = 0;
-        m_current_state = STATE::OAM_SCAN;
-        update_stat(STATE::OAM_SCAN);
-        return;
-    }
-
-    execute_dma();
-
-    m_rw_device.write(LCD_Y_COORDINATE, m_current_line, device::PPU);
+    return m_frame.data() + m_current_line * SCREEN_WIDTH;
+}
 
-    auto const LY_COMPARE = m_rw_device.read(0xFF45, device::PPU, true);
+void ppu::ppu_impl::palette_written(uint16_t addr, uint8_t value)
+{
+    // BGP colors at 0-3, OBP0 at 8-11, OBP1 at 12-15
+    size_t const first = addr == 0xFF47 ? 0 : addr == 0xFF48 ? 8 : 12;
+    auto const colors = make_palette_colors(value);
+    std::copy(colors.begin(), colors.end(), m_colors.begin() + first);
+}
 
-    if (LY_COMPARE == m_current_line)
+void ppu_registers::write(uint16_t addr, uint8_t value)
+{
+    switch (addr)
     {
-        uint8_t STAT = m_rw_device.read(0xFF41, device::PPU, true);
-        setbit(STAT, 2);
-        m_rw_device.write(0xFF41, STAT, device::PPU, true);
-
-        // LYC == LY INT
-        if (checkbit(STAT, 6))
-        {
-            STAT_INT();
-        }
+    case 0xFF40:
+        m_lcdc = value;
+        m_background_map_addr = checkbit(value, 3) ? 0x9C00 : 0x9800;
+        m_signed_tile_index = !checkbit(value, 4);
+        m_window_map_addr = checkbit(value, 6) ? 0x9C00 : 0x9800;
+        m_sprite_height = checkbit(value, 2) ? 16 : 8;
+        break;
+    case 0xFF41:
+        m_stat = (m_stat & 0x87) | (value & 0x78);
+        break;
+    case 0xFF42:
+        m_scy = value;
+        break;
+    case 0xFF43:
+        m_scx = value;
+        break;
+    case 0xFF45:
+        m_lyc = value;
+        break;
+    case 0xFF46:
+        m_dma = value;
+        break;
+    case 0xFF47:
+        m_bgp = value;
+        break;
+    case 0xFF48:
+        m_obp0 = value;
+        break;
+    case 0xFF49:
+        m_obp1 = value;
+        break;
+    case 0xFF4A:
+        m_wy = value;
+        break;
+    case 0xFF4B:
+        m_wx = value;
+        break;
     }
+}
+
+void ppu::ppu_impl::register_written(uint16_t addr, uint8_t value)
+{
+    bool const was_on = checkbit(m_registers.m_lcdc, 7);
+    m_registers.write(addr, value);
 
-    switch (m_current_state)
+    switch (addr)
     {
-    case STATE::OAM_SCAN:
-        OAM_SCAN();
+    case 0xFF40:
+        if (was_on != static_cast<bool>(checkbit(value, 7)))
+            lcd_switched();
         break;
-    case STATE::DRAWING_PIXELS:
-        DRAWING_PIXELS();
+    case 0xFF41:
+        // mode and LY == LYC bits are not writable
+        m_rw_device.write(0xFF41, m_registers.m_stat, device::PPU, true);
+        update_stat();
         break;
-    case STATE::HORIZONTAL_BLANK:
-        HORIZONTAL_BLANK();
+    case 0xFF45:
+        // LYC change can raise interrupt
+        update_stat();
         break;
-    case STATE::VERTICAL_BLANK:
-        VERTICAL_BLANK();
+    case 0xFF44:
+        m_rw_device.write(LCD_Y_COORDINATE, m_registers.m_ly, device::PPU);
         break;
+    case 0xFF47:
+    case 0xFF48:
+    case 0xFF49:
+        palette_written(addr, value);
+        break;
+    }
+}
+
+void ppu::ppu_impl::reload_palettes()
+{
+    palette_written(0xFF47, m_registers.m_bgp);
+    palette_written(0xFF48, m_registers.m_obp0);
+    palette_written(0xFF49, m_registers.m_obp1);
+}
+
+void ppu::ppu_impl::dot()
+{
+    if (!checkbit(m_registers.m_lcdc, 7))
+        return;
+
+    // Only the FIFO works on every dot of mode 3, the rest waits for the next event
+    if (m_current_state == STATE::DRAWING_PIXELS && !m_line_drawn)
+    {
+        m_line_drawn = m_renderer == renderer::FIFO ? draw_pixel_line() : draw_line();
+        if (m_line_drawn && !m_render_thread)
+            m_drawing_device.after_line(m_current_line, line_view{line_pixels(), SCREEN_WIDTH});
     }
 
-    ++m_current_dot;
+    if (++m_current_dot == m_next_event_dot)
+        next_event();
 }
 
-void ppu::ppu_impl::dma(uint8_t src_addr)
+void ppu::ppu_impl::set_renderer(renderer r)
 {
-    // dma_source ==  0x[src_addr]00
-    dma_source = 0;
-    dma_source = src_addr;
-    dma_source <<= 8;
-    dma_counter = 160;
+    finish_lines();
+    // fifo does not keep line keys
+    m_valid_line_keys.reset();
+    m_renderer = r;
+    if (r != renderer::THREADED)
+        m_render_thread.reset();
+    else if (!m_render_thread)
+    {
+        m_vram.load(m_rw_device);
+        m_render_thread = std::make_unique<render_thread>();
+    }
+}
+
+void ppu::ppu_impl::vram_written(uint16_t addr)
+{
+    m_tile_cache.invalidate(addr);
+    if (addr < tile_cache::TILE_DATA_END)
+        ++m_tile_data_generation;
+    else
+        ++m_map_row_generations[(addr - tile_cache::TILE_DATA_END) / 32];
+    if (m_render_thread)
+        m_vram.write(addr, m_rw_device.read(addr, device::PPU, true));
 }
 
-void ppu::ppu_impl::execute_dma()
+void ppu::ppu_impl::finish_lines()
 {
-    if (dma_counter != 0)
+    if (!m_render_thread || m_queued_lines.none())
+        return;
+
+    m_render_thread->wait();
+    for (size_t y = 0; y < SCREEN_HEIGHT; ++y)
     {
-        uint8_t const value = m_rw_device.read(dma_source, device::PPU);
-        uint16_t destination{0xFE00};
-        destination |= (dma_source & 0xFF);
-        m_rw_device.write(destination, value, device::PPU);
-        ++dma_source;
-        --dma_counter;
+        if (m_queued_lines.test(y))
+            m_drawing_device.after_line(static_cast<uint8_t>(y), line_view{m_frame.data() + y * SCREEN_WIDTH, SCREEN_WIDTH});
     }
+    m_queued_lines.reset();
+}
+
+void ppu::ppu_impl::set_frame_skip(uint32_t frames)
+{
+    // the next frame is drawn, logic only stops drawing at once
+    m_frame_skip = frames;
+    m_skipped_frames = frames;
+    if (frames == LOGIC_ONLY)
+        m_skip_frame = true;
+}
+
+void ppu::ppu_impl::start_frame()
+{
+    m_skip_frame = m_frame_skip == LOGIC_ONLY || m_skipped_frames < m_frame_skip;
+    m_skipped_frames = m_skip_frame ? m_skipped_frames + 1 : 0;
 }
 
 STATE ppu::ppu_impl::current_state() const
@@ -87,6 +184,27 @@ STATE ppu::ppu_impl::current_state() const
     return m_current_state;
 }
 
+ppu_state ppu::ppu_impl::save_state() const
+{
+    return *this;
+}
+
+void ppu::ppu_impl::load_state(ppu_state const &state)
+{
+    finish_lines();
+    static_cast<ppu_state &>(*this) = state;
+    // logic only never draws, even when the state was saved in a drawn frame
+    if (m_frame_skip == LOGIC_ONLY)
+        m_skip_frame = true;
+
+    // memory is restored too
+    m_tile_cache.invalidate_all();
+    m_valid_line_keys.reset();
+    if (m_render_thread)
+        m_vram.load(m_rw_device);
+    reload_palettes();
+}
+
 // ******************************************
 //                  PPU PART
 // ******************************************
@@ -101,13 +219,74 @@ void ppu::dot()
     m_pimpl->dot();
 }
 
-void ppu::dma(uint8_t src_addr)
+STATE ppu::current_state() const
 {
-    assert(src_addr >= 0 && src_addr <= 0xDF);
-    m_pimpl->dma(src_addr);
+    return m_pimpl->current_state();
 }
 
-STATE ppu::current_state() const
+void ppu::vram_written(uint16_t addr)
 {
-    return m_pimpl->current_state();
+    m_pimpl->vram_written(addr);
+}
+
+void ppu::oam_written(uint16_t addr, uint8_t value)
+{
+    m_pimpl->m_oam.write(addr, value);
+}
+
+void ppu::oam_dma(std::span<uint8_t const, oam_mirror::OAM_SIZE> oam)
+{
+    m_pimpl->m_oam.load(oam);
+}
+
+void ppu::register_written(uint16_t addr, uint8_t value)
+{
+    m_pimpl->register_written(addr, value);
+}
+
+void ppu::set_frame_buffer(frame_buffer buffer)
+{
+    frame_buffer_changed();
+    m_pimpl->m_frame = buffer;
+}
+
+frame_buffer ppu::current_frame_buffer() const
+{
+    return m_pimpl->m_frame;
+}
+
+void ppu::frame_buffer_changed()
+{
+    m_pimpl->finish_lines();
+    m_pimpl->m_valid_line_keys.reset();
+}
+
+void ppu::set_renderer(renderer r)
+{
+    m_pimpl->set_renderer(r);
+}
+
+renderer ppu::current_renderer() const
+{
+    return m_pimpl->m_renderer;
+}
+
+void ppu::set_frame_skip(uint32_t frames)
+{
+    m_pimpl->set_frame_skip(frames);
+}
+
+uint32_t ppu::frame_skip() const
+{
+    return m_pimpl->m_frame_skip;
+}
+
+ppu_state ppu::save_state() const
+{
+    return m_pimpl->save_state();
+}
+
+void ppu::load_state(ppu_state const &state)
+{
+    m_pimpl->load_state(state);
 }
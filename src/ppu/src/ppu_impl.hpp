@@ -3,45 +3,87 @@
 
 #include <ppu.hpp>
 #include "pixel_fetcher.hpp"
-#include <vector>
+#include "pixel_fifo.hpp"
+#include "render_thread.hpp"
+#include "scanline.hpp"
+#include "tile_cache.hpp"
+#include "vram_copy.hpp"
+#include <bitset>
+#include <memory>
 
-struct ppu::ppu_impl
+// Mode, counters and line state come from ppu_state
+struct ppu::ppu_impl : public ppu_state
 {
     ppu_impl(rw_device &rw_device, drawing_device &drawing_device);
     rw_device &m_rw_device;
     drawing_device &m_drawing_device;
     pixel_fetcher m_pixel_fetcher;
+    tile_cache m_tile_cache;
 
-    // temporary value of 0xFF40 ( lcd control )
-    uint8_t m_lcd_ctrl{};
+    // Pixels go to m_frame, which is m_own_frame unless caller gave its buffer
+    std::array<color, SCREEN_WIDTH * SCREEN_HEIGHT> m_own_frame{};
+    frame_buffer m_frame{m_own_frame};
+    color *line_pixels();
 
-    // temporary value of visible sprites in each drawing line
-    std::vector<sprite> visible_sprites{};
-
-    void update_stat(STATE s);
+    // Colors of all palettes indexed by pixel_color_index, rebuilt on palette writes
+    std::array<color, 16> m_colors{};
+    void register_written(uint16_t addr, uint8_t value);
+    void palette_written(uint16_t addr, uint8_t value);
+    void reload_palettes();
 
+    // ppu_modes.cpp
+    // Mode changes and LY changes are events, registers are written only then
+    void next_event();
+    void start_line(int line);
+    void OAM_SCAN();
+    void DRAWING_PIXELS();
+    void HORIZONTAL_BLANK();
+    void VERTICAL_BLANK();
+    int drawing_length(uint8_t scroll_x) const;
+    void lcd_switched();
+    void update_stat();
+    void set_ly(uint8_t ly);
     void STAT_INT();
 
     bool draw_pixel_line();
+    void reset_line();
 
-    void dot();
+    // 8 color ids of visible sprite in current line, already flipped
+    uint8_t const *sprite_line(sprite const &s);
 
-    int dma_counter{};
-    uint16_t dma_source{};
-    void dma(uint8_t src_addr);
-    void execute_dma();
+    // scanline.cpp
+    renderer m_renderer{renderer::FIFO};
+    bool draw_line();
+    line_snapshot snapshot_line() const;
+    void render_line();
 
-    STATE m_current_state{STATE::OAM_SCAN};
+    // THREADED renderer, lines queued in this frame are reported when they are all drawn
+    std::unique_ptr<render_thread> m_render_thread;
+    vram_copy m_vram;
+    std::bitset<SCREEN_HEIGHT> m_queued_lines;
+    void set_renderer(renderer r);
+    void vram_written(uint16_t addr);
+    void finish_lines();
 
-    STATE current_state() const;
+    // Keys of lines drawn by scanline renderers, a line with the same key is left as it is in the frame buffer
+    // 64 rows of both tile maps from 0x9800
+    uint32_t m_tile_data_generation{};
+    std::array<uint32_t, 64> m_map_row_generations{};
+    std::array<line_key, SCREEN_HEIGHT> m_line_keys{};
+    std::bitset<SCREEN_HEIGHT> m_valid_line_keys;
+    line_key make_line_key(line_snapshot const &line) const;
 
-    void OAM_SCAN();
-    void DRAWING_PIXELS();
-    void HORIZONTAL_BLANK();
-    void VERTICAL_BLANK();
+    // Setting of the host like the renderer, so it is not saved, only the skip phase is in ppu_state
+    uint32_t m_frame_skip{};
+    void set_frame_skip(uint32_t frames);
+    void start_frame();
+
+    void dot();
+
+    STATE current_state() const;
 
-    int m_current_dot{};
-    int m_current_line{};
+    ppu_state save_state() const;
+    void load_state(ppu_state const &state);
 };
 
 #endif
\ No newline at end of file
@@ -1,100 +1,219 @@
 #include "ppu_impl.hpp"
-#include <iostream>
+#include "oam_scan.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
 
 namespace
 {
 
-sprite load_sprite(rw_device &rw, uint16_t addr)
-{
-    sprite result;
-    result.m_y_pos = rw.read(addr++, device::PPU);
-    result.m_x_pos = rw.read(addr++, device::PPU);
-    result.m_tile_index = rw.read(addr++, device::PPU);
-    result.m_flags = rw.read(addr, device::PPU);
-    return result;
-}
+constexpr int OAM_SCAN_DOTS{80};
+constexpr int LINE_DOTS{456};
+constexpr int VISIBLE_LINES{144};
+constexpr int LINES{154};
 
-// Address where sprites reside, there are 40x of them
-constexpr uint16_t OAM_ADDR{0xFE00};
+// Mode 3 without sprites and window, SCX % 8 is added
+constexpr int DRAWING_MIN_DOTS{172};
+constexpr int WINDOW_PENALTY{6};
+constexpr int SPRITE_PENALTY{6};
+constexpr int SPRITE_AT_ZERO_PENALTY{11};
 
-bool check_line{};
+// STAT bits 0-1
+uint8_t mode_bits(STATE s)
+{
+    switch (s)
+    {
+    case STATE::HORIZONTAL_BLANK:
+        return 0;
+    case STATE::VERTICAL_BLANK:
+        return 1;
+    case STATE::OAM_SCAN:
+        return 2;
+    case STATE::DRAWING_PIXELS:
+        return 3;
+    }
+    return 0;
+}
 
 } // namespace
 
-void ppu::ppu_impl::OAM_SCAN()
+void ppu::ppu_impl::next_event()
 {
-    // when OBJ is enabled in FF40 - LCD Control
-    // Do it once for each line
-    if (checkbit(m_lcd_ctrl, 1) && !check_line)
+    switch (m_current_state)
     {
-        update_stat(STATE::OAM_SCAN);
+    case STATE::OAM_SCAN:
+        DRAWING_PIXELS();
+        break;
+    case STATE::DRAWING_PIXELS:
+        HORIZONTAL_BLANK();
+        break;
+    case STATE::HORIZONTAL_BLANK:
+    case STATE::VERTICAL_BLANK:
+        start_line(m_current_line + 1);
+        break;
+    }
+}
 
-        check_line = true;
-        visible_sprites.clear();
-        uint8_t const sprite_high = checkbit(m_lcd_ctrl, 2) ? 16 : 8;
+void ppu::ppu_impl::start_line(int line)
+{
+    m_current_dot = 0;
+    if (line == LINES)
+    {
+        line = 0;
+        finish_lines();
+        if (!m_skip_frame)
+            m_drawing_device.after_frame(m_frame);
+    }
 
-        for (int addr = OAM_ADDR; addr < OAM_ADDR + (40 * sizeof(sprite)); addr += sizeof(sprite))
-        {
-            sprite s{load_sprite(m_rw_device, addr)};
-            if (m_current_line >= (s.m_y_pos - 16) && m_current_line <= (s.m_y_pos - 16 + sprite_high))
-            {
-                visible_sprites.push_back(s);
-                if (visible_sprites.size() == 10)
-                    break;
-            }
-        }
+    m_current_line = line;
+    set_ly(line);
+
+    if (line == 0)
+    {
+        start_frame();
+        m_window_y_triggered = false;
+        m_window_line = 0;
     }
+    if (line == m_registers.m_wy)
+        m_window_y_triggered = true;
 
-    if (m_current_dot == 80)
+    if (m_current_line < VISIBLE_LINES)
+        OAM_SCAN();
+    else if (m_current_line == VISIBLE_LINES)
+        VERTICAL_BLANK();
+    else
     {
-        check_line = false;
-        m_pixel_fetcher.update_addresses();
-        m_current_state = STATE::DRAWING_PIXELS;
-        update_stat(STATE::DRAWING_PIXELS);
+        m_next_event_dot = LINE_DOTS;
+        update_stat();
     }
 }
 
+void ppu::ppu_impl::OAM_SCAN()
+{
+    m_current_state = STATE::OAM_SCAN;
+    m_next_event_dot = OAM_SCAN_DOTS;
+
+    // Sprites of the whole line are taken at once
+    m_visible_sprites_count = 0;
+    if (checkbit(m_registers.m_lcdc, 1))
+        m_visible_sprites_count = select_sprites(m_oam, m_current_line, m_registers.m_sprite_height, m_visible_sprites);
+
+    update_stat();
+}
+
 void ppu::ppu_impl::DRAWING_PIXELS()
 {
-    if (draw_pixel_line())
-    {
-        m_current_state = STATE::HORIZONTAL_BLANK;
-        update_stat(STATE::HORIZONTAL_BLANK);
-    }
+    uint8_t const lcdc = m_registers.m_lcdc;
+    m_window_on_line = checkbit(lcdc, 0) && checkbit(lcdc, 5) && m_window_y_triggered && m_registers.m_wx <= 166;
+    // line of skipped frame counts as drawn, mode 3 still takes its time
+    m_line_drawn = m_skip_frame;
+    m_current_state = STATE::DRAWING_PIXELS;
+    m_next_event_dot = OAM_SCAN_DOTS + drawing_length(m_registers.m_scx);
+    update_stat();
 }
 
 void ppu::ppu_impl::HORIZONTAL_BLANK()
 {
-    if (m_current_dot == 456)
+    // mode 3 is never shorter than the fifo needs for the line
+    assert(m_line_drawn);
+    if (m_window_on_line)
+        ++m_window_line;
+    m_current_state = STATE::HORIZONTAL_BLANK;
+    m_next_event_dot = LINE_DOTS;
+    update_stat();
+}
+
+void ppu::ppu_impl::VERTICAL_BLANK()
+{
+    m_current_state = STATE::VERTICAL_BLANK;
+    m_next_event_dot = LINE_DOTS;
+    update_stat();
+
+    auto interrupt_flag = m_rw_device.read(INTERRUPT_FLAG, device::PPU); // load old if
+    setbit(interrupt_flag, 0);                                           // activate Vblank
+    m_rw_device.write(INTERRUPT_FLAG, interrupt_flag, device::PPU);      // save new if
+}
+
+// https://gbdev.io/pandocs/Rendering.html#mode-3-length
+int ppu::ppu_impl::drawing_length(uint8_t scroll_x) const
+{
+    int length = DRAWING_MIN_DOTS + scroll_x % 8;
+
+    if (m_window_on_line)
+        length += WINDOW_PENALTY;
+
+    // Sprite waits for the background tile under its leftmost pixel, once per tile
+    std::array<bool, 32> tile_fetched{};
+    for (int s = 0; s < m_visible_sprites_count; ++s)
     {
-        m_current_dot = 0;
-        ++m_current_line;
-        if (m_current_line == 144)
+        uint8_t const x = m_visible_sprites[s].m_x_pos;
+        if (x >= 168)
+            continue;
+        if (x == 0)
         {
-            m_current_state = STATE::VERTICAL_BLANK;
-            update_stat(STATE::VERTICAL_BLANK);
-            auto interrupt_flag = m_rw_device.read(INTERRUPT_FLAG, device::PPU); // load old if
-            setbit(interrupt_flag, 0);                                           // activate Vblank
-            m_rw_device.write(INTERRUPT_FLAG, interrupt_flag, device::PPU);      // save new if
+            length += SPRITE_AT_ZERO_PENALTY;
+            continue;
         }
-        else
+
+        size_t const tile = (x + scroll_x % 8) / 8;
+        if (!tile_fetched[tile])
         {
-            m_current_state = STATE::OAM_SCAN;
+            tile_fetched[tile] = true;
+            length += std::max(0, 5 - (x + scroll_x) % 8);
         }
+        length += SPRITE_PENALTY;
     }
+    return length;
 }
 
-void ppu::ppu_impl::VERTICAL_BLANK()
+void ppu::ppu_impl::lcd_switched()
 {
-    if (m_current_dot == 456)
+    if (!checkbit(m_registers.m_lcdc, 7))
     {
-        m_current_dot = -1;
-        ++m_current_line;
-        if (m_current_line == 154)
-        {
-            m_current_line = 0;
-            m_current_state = STATE::OAM_SCAN;
-            m_drawing_device.after_frame();
-        }
+        // LY stays 0 and mode is HBlank while LCD is off
+        m_current_state = STATE::HORIZONTAL_BLANK;
+        m_current_dot = m_current_line = 0;
+        set_ly(0);
+        update_stat();
+        reset_line();
+        finish_lines();
     }
+    else
+        start_line(0);
+}
+
+void ppu::ppu_impl::update_stat()
+{
+    uint8_t const stat = m_registers.m_stat;
+    bool const lcd_on = checkbit(m_registers.m_lcdc, 7);
+    bool const coincidence = m_registers.m_lyc == m_current_line;
+    uint8_t const mode = lcd_on ? mode_bits(m_current_state) : 0;
+
+    // bit 7 is unused and reads 1, 3-6 are interrupt sources set by CPU
+    uint8_t const new_stat = 0x80 | (stat & 0x78) | (coincidence ? 0x04 : 0) | mode;
+    if (new_stat != stat)
+    {
+        m_registers.m_stat = new_stat;
+        m_rw_device.write(0xFF41, new_stat, device::PPU, true);
+    }
+
+    // interrupt only when the line goes up, not again while a source stays on
+    bool const stat_line = lcd_on && ((coincidence && checkbit(new_stat, 6)) || (mode == 0 && checkbit(new_stat, 3)) ||
+                                      (mode == 1 && checkbit(new_stat, 4)) || (mode == 2 && checkbit(new_stat, 5)));
+    if (stat_line && !m_stat_line)
+        STAT_INT();
+    m_stat_line = stat_line;
+}
+
+void ppu::ppu_impl::set_ly(uint8_t ly)
+{
+    m_registers.m_ly = ly;
+    m_rw_device.write(LCD_Y_COORDINATE, ly, device::PPU);
+}
+
+void ppu::ppu_impl::STAT_INT()
+{
+    uint8_t IF = m_rw_device.read(0xFF0F, device::PPU, true);
+    setbit(IF, 1);
+    m_rw_device.write(0xFF0F, IF, device::PPU, true);
 }
@@ -0,0 +1,72 @@
+#include "render_thread.hpp"
+#include <cassert>
+
+render_thread::render_thread() : m_thread{&render_thread::work, this}
+{
+}
+
+render_thread::~render_thread()
+{
+    m_queue.push(job{});
+    m_queue.wake_consumer();
+    m_thread.join();
+}
+
+void render_thread::push(line_snapshot const &line, std::shared_ptr<vram_copy::pages const> vram, color *out)
+{
+    assert(out);
+    m_queue.push(job{line, std::move(vram), out});
+    if (++m_pushed % LINES_PER_WAKE == 0)
+        m_queue.wake_consumer();
+}
+
+void render_thread::wait()
+{
+    m_queue.wake_consumer();
+    for (uint64_t done = m_done.load(std::memory_order_acquire); done != m_pushed;
+         done = m_done.load(std::memory_order_acquire))
+        m_done.wait(done, std::memory_order_acquire);
+}
+
+void render_thread::work()
+{
+    while (true)
+    {
+        job j{m_queue.pop()};
+        if (!j.m_out)
+            break;
+
+        use_vram(std::move(j.m_vram));
+        render_line(j.m_line, *this, m_tile_cache, j.m_out);
+
+        m_done.fetch_add(1, std::memory_order_release);
+        m_done.notify_one();
+    }
+}
+
+void render_thread::use_vram(std::shared_ptr<vram_copy::pages const> vram)
+{
+    if (vram == m_vram)
+        return;
+
+    // written pages are new ones, their tiles are decoded again
+    for (size_t p = 0; p < vram_copy::PAGE_COUNT; ++p)
+    {
+        if (m_vram && (*vram)[p] == (*m_vram)[p])
+            continue;
+        uint16_t const page_addr = static_cast<uint16_t>(vram_copy::VRAM_ADDR + p * vram_copy::PAGE_SIZE);
+        for (uint16_t addr = page_addr; addr < page_addr + vram_copy::PAGE_SIZE; addr += 16)
+            m_tile_cache.invalidate(addr);
+    }
+    m_vram = std::move(vram);
+}
+
+uint8_t render_thread::read(uint16_t addr, device, bool)
+{
+    return vram_copy::read(*m_vram, addr);
+}
+
+void render_thread::write(uint16_t, uint8_t, device, bool)
+{
+    assert(false && "render thread does not write");
+}
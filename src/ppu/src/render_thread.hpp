@@ -0,0 +1,60 @@
+#ifndef RENDER_THREAD_HPP
+#define RENDER_THREAD_HPP
+
+#include <common.hpp>
+#include <spsc_queue.hpp>
+#include "scanline.hpp"
+#include "tile_cache.hpp"
+#include "vram_copy.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Scanline renderer on its own thread, emulation thread only queues line snapshots
+// Tiles are cached again on this thread, VRAM is read from the snapshot of the line
+class render_thread : private rw_device
+{
+  public:
+    render_thread();
+    ~render_thread();
+
+    render_thread(render_thread const &) = delete;
+    render_thread &operator=(render_thread const &) = delete;
+
+    // Pixels go to out, waits while the queue is full
+    void push(line_snapshot const &line, std::shared_ptr<vram_copy::pages const> vram, color *out);
+
+    // Waits until every queued line is drawn, its pixels can be read then
+    void wait();
+
+  private:
+    // Line without output stops the thread
+    struct job
+    {
+        line_snapshot m_line;
+        std::shared_ptr<vram_copy::pages const> m_vram;
+        color *m_out{};
+    };
+
+    // more than a frame, emulation thread waits for the lines only at the end of frame
+    static constexpr size_t QUEUE_CAPACITY{256};
+    static constexpr uint64_t LINES_PER_WAKE{16};
+    spsc_queue<job, QUEUE_CAPACITY> m_queue;
+    uint64_t m_pushed{};
+    std::atomic<uint64_t> m_done{};
+
+    // used only by the thread, the last VRAM is kept so its pages cannot be reused at the same address
+    tile_cache m_tile_cache{*this};
+    std::shared_ptr<vram_copy::pages const> m_vram;
+
+    std::thread m_thread;
+
+    void work();
+    void use_vram(std::shared_ptr<vram_copy::pages const> vram);
+
+    uint8_t read(uint16_t addr, device d, bool direct) override;
+    void write(uint16_t addr, uint8_t data, device d, bool direct) override;
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include "ppu_impl.hpp"
+#include <algorithm>
+#include <array>
+
+namespace
+{
+
+// First dot of DRAWING_PIXELS, OAM scan takes dots 0-79
+constexpr int DRAWING_FIRST_DOT{80};
+
+constexpr uint16_t TILE_LINE_SIZE_B{2};
+constexpr size_t TILES_IN_TILEMAP_ROW{32};
+constexpr size_t LINE_WIDTH{SCREEN_WIDTH};
+
+} // namespace
+
+// Keeps timing of the fifo: one pixel per dot after discarded ones
+bool ppu::ppu_impl::draw_line()
+{
+    if (m_current_dot == DRAWING_FIRST_DOT)
+    {
+        m_scroll_x = m_registers.m_scx;
+        m_scroll_y = m_registers.m_scy;
+        // fifo also discards window pixels left of the screen
+        m_pixel_count_to_discard = m_scroll_x % 8 + (m_window_on_line && m_registers.m_wx < 7 ? 7 - m_registers.m_wx : 0);
+    }
+
+    if (m_current_dot < DRAWING_FIRST_DOT + static_cast<int>(LINE_WIDTH) - 1 + m_pixel_count_to_discard)
+        return false;
+
+    render_line();
+    reset_line();
+    return true;
+}
+
+line_snapshot ppu::ppu_impl::snapshot_line() const
+{
+    line_snapshot line;
+    line.m_registers = m_registers;
+    line.m_colors = m_colors;
+    line.m_sprites = m_visible_sprites;
+    line.m_sprite_count = m_visible_sprites_count;
+    line.m_line = static_cast<uint8_t>(m_current_line);
+    line.m_scroll_x = m_scroll_x;
+    line.m_scroll_y = m_scroll_y;
+    line.m_window_on_line = m_window_on_line;
+    line.m_window_line = m_window_line;
+    line.m_first_pixel = m_pushed_pixels;
+    return line;
+}
+
+line_key ppu::ppu_impl::make_line_key(line_snapshot const &line) const
+{
+    auto const row_generation = [this](uint16_t map_addr, uint8_t y) {
+        return m_map_row_generations[(map_addr - 0x9800) / TILES_IN_TILEMAP_ROW + y / 8];
+    };
+
+    line_key key;
+    key.m_line = line;
+    key.m_tile_data_generation = m_tile_data_generation;
+    key.m_background_row_generation =
+        row_generation(line.m_registers.m_background_map_addr, static_cast<uint8_t>(line.m_line + line.m_scroll_y));
+    if (line.m_window_on_line)
+        key.m_window_row_generation = row_generation(line.m_registers.m_window_map_addr, line.m_window_line);
+    return key;
+}
+
+void ppu::ppu_impl::render_line()
+{
+    line_snapshot const line{snapshot_line()};
+    line_key const key{make_line_key(line)};
+    bool const unchanged = m_valid_line_keys.test(line.m_line) && m_line_keys[line.m_line] == key;
+    m_line_keys[line.m_line] = key;
+    m_valid_line_keys.set(line.m_line);
+
+    if (m_render_thread)
+    {
+        if (!unchanged)
+            m_render_thread->push(line, m_vram.snapshot(), line_pixels());
+        m_queued_lines.set(line.m_line);
+    }
+    else if (!unchanged)
+        ::render_line(line, m_rw_device, m_tile_cache, line_pixels());
+}
+
+void render_line(line_snapshot const &line, rw_device &vram, tile_cache &tiles, color *out)
+{
+    ppu_registers const &registers = line.m_registers;
+    std::array<uint8_t, LINE_WIDTH + 8> background{};
+
+    // Background, tile by tile starting with the one under SCX
+    uint8_t const y = line.m_line + line.m_scroll_y;
+    uint16_t const map_row = registers.m_background_map_addr + (y / 8) * TILES_IN_TILEMAP_ROW;
+    uint8_t const first_tile = line.m_scroll_x / 8;
+    for (size_t t = 0; t <= LINE_WIDTH / 8; ++t)
+    {
+        uint16_t const map_addr = map_row + ((first_tile + t) % TILES_IN_TILEMAP_ROW);
+        uint8_t const tile_index = vram.read(map_addr, device::PPU, true);
+        uint16_t const tile_addr = registers.tile_addr(tile_index) + (y % 8) * TILE_LINE_SIZE_B;
+        std::copy_n(tiles.line(tile_addr), 8, background.begin() + t * 8);
+    }
+    uint8_t *const pixels = background.data() + line.m_scroll_x % 8;
+
+    // Window covers the rest of the line from WX - 7, copied as one run
+    if (line.m_window_on_line)
+    {
+        std::array<uint8_t, LINE_WIDTH + 8> window{};
+        uint16_t const window_row = registers.m_window_map_addr + (line.m_window_line / 8) * TILES_IN_TILEMAP_ROW;
+        size_t const start = registers.m_wx < 7 ? 0 : registers.m_wx - 7;
+        size_t const skip = registers.m_wx < 7 ? 7 - registers.m_wx : 0;
+        size_t const count = (LINE_WIDTH - start + skip + 7) / 8;
+        for (size_t t = 0; t < count; ++t)
+        {
+            uint8_t const tile_index = vram.read(window_row + t, device::PPU, true);
+            uint16_t const tile_addr = registers.tile_addr(tile_index) + (line.m_window_line % 8) * TILE_LINE_SIZE_B;
+            std::copy_n(tiles.line(tile_addr), 8, window.begin() + t * 8);
+        }
+        std::copy_n(window.begin() + skip, LINE_WIDTH - start, pixels + start);
+    }
+
+    // Sprites, the one with lower X is placed first, the same X keeps OAM order
+    // Earlier sprite keeps its pixels, only transparent ones are taken, as in sprite fifo
+    std::array<sprite, 10> sprites{line.m_sprites};
+    std::stable_sort(sprites.begin(), sprites.begin() + line.m_sprite_count,
+                     [](sprite const &l, sprite const &r) { return l.m_x_pos < r.m_x_pos; });
+
+    std::array<uint8_t, LINE_WIDTH> sprite_pixels{};
+    for (int s = 0; s < line.m_sprite_count; ++s)
+    {
+        sprite const &vs = sprites[s];
+        if (vs.m_x_pos < 8 || vs.m_x_pos >= LINE_WIDTH + 8)
+            continue;
+
+        uint8_t const sprite_top_y = vs.m_y_pos - 16;
+        uint8_t const diff = line.m_line - sprite_top_y;
+        uint16_t const addr = vs.line_addr(diff, registers.m_sprite_height);
+        uint8_t const *ids = vs.x_flip() ? tiles.flipped_line(addr) : tiles.line(addr);
+
+        uint8_t const attributes = PIXEL_SPRITE | (vs.priority() ? PIXEL_PRIORITY : 0) | (vs.palette() ? PIXEL_PALETTE : 0);
+        size_t const x = vs.m_x_pos - 8;
+        size_t const count = std::min<size_t>(8, LINE_WIDTH - x);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (ids[i] != 0 && (sprite_pixels[x + i] & PIXEL_COLOR_ID) == 0)
+                sprite_pixels[x + i] = attributes | ids[i];
+        }
+    }
+
+    for (size_t i = line.m_first_pixel; i < LINE_WIDTH; ++i)
+        out[i] = line.m_colors[pixel_color_index(mix_pixels(pixels[i], sprite_pixels[i]))];
+}
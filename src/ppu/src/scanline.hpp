@@ -0,0 +1,41 @@
+#ifndef SCANLINE_HPP
+#define SCANLINE_HPP
+
+#include <ppu.hpp>
+#include "tile_cache.hpp"
+#include <array>
+#include <cstdint>
+
+// Everything scanline renderer reads for one line, taken when mode 3 of the line ends
+struct line_snapshot
+{
+    ppu_registers m_registers;  // palettes and LCDC as they are at the end of the line
+    std::array<color, 16> m_colors{};
+    std::array<sprite, 10> m_sprites{};
+    uint8_t m_sprite_count{};
+    uint8_t m_line{};
+    uint8_t m_scroll_x{}; // SCX and SCY as they were at the start of mode 3
+    uint8_t m_scroll_y{};
+    bool m_window_on_line{};
+    uint8_t m_window_line{};
+    uint8_t m_first_pixel{}; // pixels before it were already pushed by fifo
+
+    bool operator==(line_snapshot const &) const = default;
+};
+
+// Line gives the same pixels as in previous frame when its snapshot and the VRAM it reads are the same
+// VRAM is followed by generations, counted up on writes to tile data and to each tile map row
+struct line_key
+{
+    line_snapshot m_line;
+    uint32_t m_tile_data_generation{};
+    uint32_t m_background_row_generation{};
+    uint32_t m_window_row_generation{};
+
+    bool operator==(line_key const &) const = default;
+};
+
+// Tiles come from cache, tile maps are read through vram
+void render_line(line_snapshot const &line, rw_device &vram, tile_cache &tiles, color *out);
+
+#endif
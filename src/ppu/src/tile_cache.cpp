@@ -0,0 +1,66 @@
+#include "tile_cache.hpp"
+#include "pixel_fifo.hpp"
+#include "tile_decode.hpp"
+#include <algorithm>
+#include <cassert>
+
+tile_cache::tile_cache(rw_device &rw) : m_rw{rw}
+{
+    invalidate_all();
+}
+
+uint8_t const *tile_cache::line(uint16_t line_addr)
+{
+    if (line_addr < TILE_DATA_ADDR || line_addr + 1 >= TILE_DATA_END)
+    {
+        decode_tile_line(m_rw.read(line_addr, device::PPU, true), m_rw.read(line_addr + 1, device::PPU, true),
+                         m_uncached.data());
+        return m_uncached.data();
+    }
+    return cached_line(m_tiles, line_addr);
+}
+
+uint8_t const *tile_cache::flipped_line(uint16_t line_addr)
+{
+    if (line_addr < TILE_DATA_ADDR || line_addr + 1 >= TILE_DATA_END)
+    {
+        line(line_addr);
+        std::reverse(m_uncached.begin(), m_uncached.end());
+        return m_uncached.data();
+    }
+    return cached_line(m_flipped_tiles, line_addr);
+}
+
+uint8_t const *tile_cache::cached_line(std::array<tile, TILE_COUNT> const &tiles, uint16_t line_addr)
+{
+    // tile lines start at even addresses
+    assert(line_addr % 2 == 0);
+    size_t const offset = line_addr - TILE_DATA_ADDR;
+    size_t const index = offset / 16;
+    if (m_dirty[index])
+        decode(index);
+    return tiles[index][(offset % 16) / 2].data();
+}
+
+void tile_cache::invalidate(uint16_t addr)
+{
+    if (addr >= TILE_DATA_ADDR && addr < TILE_DATA_END)
+        m_dirty[(addr - TILE_DATA_ADDR) / 16] = true;
+}
+
+void tile_cache::invalidate_all()
+{
+    m_dirty.fill(true);
+}
+
+void tile_cache::decode(size_t index)
+{
+    uint16_t const tile_addr = static_cast<uint16_t>(TILE_DATA_ADDR + index * 16);
+    std::array<uint8_t, 16> data;
+    for (uint16_t b = 0; b < data.size(); ++b)
+        data[b] = m_rw.read(tile_addr + b, device::PPU, true);
+    decode_tile_lines(data.data(), 8, m_tiles[index][0].data());
+    for (size_t l = 0; l < 8; ++l)
+        std::reverse_copy(m_tiles[index][l].begin(), m_tiles[index][l].end(), m_flipped_tiles[index][l].begin());
+    m_dirty[index] = false;
+}
@@ -0,0 +1,45 @@
+#ifndef TILE_CACHE_HPP
+#define TILE_CACHE_HPP
+
+#include <common.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// All tiles of 0x8000-0x97FF decoded to color ids, 1 byte per pixel
+// Mirrored copy is kept too, so X flip costs nothing per pixel
+// Tile is decoded again on first use after VRAM write to it
+class tile_cache
+{
+  public:
+    static constexpr uint16_t TILE_DATA_ADDR{0x8000};
+    static constexpr uint16_t TILE_DATA_END{0x9800};
+    static constexpr size_t TILE_COUNT{(TILE_DATA_END - TILE_DATA_ADDR) / 16};
+
+    explicit tile_cache(rw_device &rw);
+
+    // 8 color ids of tile line which starts at given address, leftmost pixel first
+    uint8_t const *line(uint16_t line_addr);
+
+    // The same line mirrored, for sprites with X flip
+    uint8_t const *flipped_line(uint16_t line_addr);
+
+    void invalidate(uint16_t addr);
+    void invalidate_all();
+
+  private:
+    using tile = std::array<std::array<uint8_t, 8>, 8>;
+
+    rw_device &m_rw;
+    std::array<tile, TILE_COUNT> m_tiles{};
+    std::array<tile, TILE_COUNT> m_flipped_tiles{};
+    std::array<bool, TILE_COUNT> m_dirty{};
+
+    // line outside of tile data, not cached
+    std::array<uint8_t, 8> m_uncached{};
+
+    void decode(size_t index);
+    uint8_t const *cached_line(std::array<tile, TILE_COUNT> const &tiles, uint16_t line_addr);
+};
+
+#endif
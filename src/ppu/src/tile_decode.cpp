@@ -0,0 +1,158 @@
+#include "tile_decode.hpp"
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(TILE_DECODE_SSE2)
+#include <emmintrin.h>
+#endif
+#if defined(TILE_DECODE_AVX2) || defined(TILE_DECODE_BMI2)
+#include <immintrin.h>
+#endif
+
+static_assert(std::endian::native == std::endian::little, "color ids are stored through uint64_t");
+
+namespace
+{
+
+// Byte i of the value holds bit 7 - i of the index, so leftmost pixel goes first
+constexpr std::array<uint64_t, 256> make_spread_table()
+{
+    std::array<uint64_t, 256> result{};
+    for (size_t b = 0; b < 256; ++b)
+        for (size_t i = 0; i < 8; ++i)
+            if (b & (0x80 >> i))
+                result[b] |= uint64_t{1} << (i * 8);
+    return result;
+}
+
+constexpr std::array<uint64_t, 256> SPREAD{make_spread_table()};
+
+// First byte of line gives bit 1 of color id, second byte gives bit 0
+uint64_t decode_scalar(uint8_t first, uint8_t second)
+{
+    return (SPREAD[first] << 1) | SPREAD[second];
+}
+
+#if defined(TILE_DECODE_BMI2)
+uint64_t decode_bmi2(uint8_t first, uint8_t second)
+{
+    constexpr uint64_t LOW_BITS{0x0101010101010101};
+    // pdep puts bit i to byte i, pixels go from bit 7 so bytes are swapped
+    uint64_t const ids = (_pdep_u64(first, LOW_BITS) << 1) | _pdep_u64(second, LOW_BITS);
+    return __builtin_bswap64(ids);
+}
+#endif
+
+#if defined(TILE_DECODE_SSE2)
+// l holds first bytes of two lines, 8 copies each, h holds second bytes
+__m128i decode_sse2(__m128i l, __m128i h)
+{
+    __m128i const bits = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    __m128i const hi = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(l, bits), bits), _mm_set1_epi8(2));
+    __m128i const lo = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(h, bits), bits), _mm_set1_epi8(1));
+    return _mm_or_si128(hi, lo);
+}
+
+// b holds 2 lines, each byte 4 times: f0 x4 s0 x4 f1 x4 s1 x4
+void store_two_lines(__m128i b, uint8_t *ids)
+{
+    __m128i const line0 = _mm_unpacklo_epi32(b, b); // f0 x8 s0 x8
+    __m128i const line1 = _mm_unpackhi_epi32(b, b); // f1 x8 s1 x8
+    __m128i const l = _mm_unpacklo_epi64(line0, line1);
+    __m128i const h = _mm_unpackhi_epi64(line0, line1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(ids), decode_sse2(l, h));
+}
+#endif
+
+} // namespace
+
+void decode_tile_line(uint8_t first, uint8_t second, uint8_t *ids)
+{
+    uint64_t const line = decode_scalar(first, second);
+    std::memcpy(ids, &line, sizeof(line));
+}
+
+void decode_tile_lines_scalar(uint8_t const *data, size_t lines, uint8_t *ids)
+{
+    for (size_t i = 0; i < lines; ++i)
+    {
+        uint64_t const line = decode_scalar(data[i * 2], data[i * 2 + 1]);
+        std::memcpy(ids + i * 8, &line, sizeof(line));
+    }
+}
+
+#if defined(TILE_DECODE_BMI2)
+void decode_tile_lines_bmi2(uint8_t const *data, size_t lines, uint8_t *ids)
+{
+    for (size_t i = 0; i < lines; ++i)
+    {
+        uint64_t const line = decode_bmi2(data[i * 2], data[i * 2 + 1]);
+        std::memcpy(ids + i * 8, &line, sizeof(line));
+    }
+}
+#endif
+
+#if defined(TILE_DECODE_SSE2)
+// 8 lines ( whole tile ) per step
+void decode_tile_lines_sse2(uint8_t const *data, size_t lines, uint8_t *ids)
+{
+    size_t i = 0;
+    for (; i + 8 <= lines; i += 8)
+    {
+        __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i * 2));
+        __m128i const a = _mm_unpacklo_epi8(v, v); // lines 0-3, each byte twice
+        __m128i const b = _mm_unpackhi_epi8(v, v); // lines 4-7
+        store_two_lines(_mm_unpacklo_epi16(a, a), ids + i * 8);
+        store_two_lines(_mm_unpackhi_epi16(a, a), ids + i * 8 + 16);
+        store_two_lines(_mm_unpacklo_epi16(b, b), ids + i * 8 + 32);
+        store_two_lines(_mm_unpackhi_epi16(b, b), ids + i * 8 + 48);
+    }
+    for (; i < lines; ++i)
+        decode_tile_line(data[i * 2], data[i * 2 + 1], ids + i * 8);
+}
+#endif
+
+#if defined(TILE_DECODE_AVX2)
+// 8 lines per step, 4 in each 256 bit register
+void decode_tile_lines_avx2(uint8_t const *data, size_t lines, uint8_t *ids)
+{
+    // in each 128 bit lane: first bytes of 2 lines 8 times each, then second bytes
+    __m256i const first = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2, //
+                                           0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2);
+    __m256i const second = _mm256_add_epi8(first, _mm256_set1_epi8(1));
+    __m256i const bits = _mm256_setr_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1, //
+                                          -128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+
+    size_t i = 0;
+    for (; i + 8 <= lines; i += 8)
+    {
+        __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i * 2));
+        // pshufb works per 128 bit lane: lines 0-1 and 2-3 in the first register, 4-5 and 6-7 in the second
+        __m256i const lanes[2] = {_mm256_setr_m128i(v, _mm_srli_si128(v, 4)),
+                                  _mm256_setr_m128i(_mm_srli_si128(v, 8), _mm_srli_si128(v, 12))};
+        for (int half = 0; half < 2; ++half)
+        {
+            __m256i const l = _mm256_shuffle_epi8(lanes[half], first);
+            __m256i const h = _mm256_shuffle_epi8(lanes[half], second);
+            __m256i const hi = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(l, bits), bits), _mm256_set1_epi8(2));
+            __m256i const lo = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(h, bits), bits), _mm256_set1_epi8(1));
+            __m256i const result = _mm256_or_si256(hi, lo);
+            // low lane has lines 0-1 of this half, high lane lines 2-3
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(ids + i * 8 + half * 32), result);
+        }
+    }
+    for (; i < lines; ++i)
+        decode_tile_line(data[i * 2], data[i * 2 + 1], ids + i * 8);
+}
+#endif
+
+// SSE2 and BMI2 measure slower than the 2 KiB table, only AVX2 beats it
+void decode_tile_lines(uint8_t const *data, size_t lines, uint8_t *ids)
+{
+#if defined(TILE_DECODE_AVX2)
+    decode_tile_lines_avx2(data, lines, ids);
+#else
+    decode_tile_lines_scalar(data, lines, ids);
+#endif
+}
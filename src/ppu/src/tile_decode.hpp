@@ -0,0 +1,29 @@
+#ifndef TILE_DECODE_HPP
+#define TILE_DECODE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// 2bpp tile lines, 2 bytes each as they are in VRAM, to color ids, 8 per line, leftmost pixel first
+// Same result as convert_tile_line_to_color_ids for every line
+// Uses AVX2 when the build allows it ( PPU_AVX2 ), otherwise lookup table
+void decode_tile_lines(uint8_t const *data, size_t lines, uint8_t *ids);
+
+// Single line, lookup table
+void decode_tile_line(uint8_t first, uint8_t second, uint8_t *ids);
+
+// Each implementation on its own, for tests and benchmark
+void decode_tile_lines_scalar(uint8_t const *data, size_t lines, uint8_t *ids);
+#if defined(__SSE2__) || defined(_M_X64)
+#define TILE_DECODE_SSE2
+void decode_tile_lines_sse2(uint8_t const *data, size_t lines, uint8_t *ids);
+#endif
+// Defined by the build for tile_decode.cpp and users of ppu, only that file is compiled for AVX2
+#if defined(TILE_DECODE_AVX2)
+void decode_tile_lines_avx2(uint8_t const *data, size_t lines, uint8_t *ids);
+#endif
+#if defined(TILE_DECODE_BMI2)
+void decode_tile_lines_bmi2(uint8_t const *data, size_t lines, uint8_t *ids);
+#endif
+
+#endif
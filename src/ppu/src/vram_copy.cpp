@@ -0,0 +1,30 @@
+#include "vram_copy.hpp"
+#include <atomic>
+#include <cassert>
+
+void vram_copy::load(rw_device &rw)
+{
+    m_pages = std::make_shared<pages>();
+    for (size_t p = 0; p < PAGE_COUNT; ++p)
+    {
+        auto &data = (*m_pages)[p] = std::make_shared<page>();
+        for (size_t b = 0; b < PAGE_SIZE; ++b)
+            (*data)[b] = rw.read(static_cast<uint16_t>(VRAM_ADDR + p * PAGE_SIZE + b), device::PPU, true);
+    }
+}
+
+void vram_copy::write(uint16_t addr, uint8_t value)
+{
+    assert(addr >= VRAM_ADDR && addr < VRAM_ADDR + PAGE_COUNT * PAGE_SIZE);
+
+    // Other owners are snapshots only, they can release but never take a reference
+    // so use count 1 stays 1, the fence orders our write after their last read
+    if (m_pages.use_count() > 1)
+        m_pages = std::make_shared<pages>(*m_pages);
+    std::shared_ptr<page> &data = (*m_pages)[(addr - VRAM_ADDR) / PAGE_SIZE];
+    if (data.use_count() > 1)
+        data = std::make_shared<page>(*data);
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    (*data)[(addr - VRAM_ADDR) % PAGE_SIZE] = value;
+}
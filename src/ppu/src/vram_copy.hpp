@@ -0,0 +1,42 @@
+#ifndef VRAM_COPY_HPP
+#define VRAM_COPY_HPP
+
+#include <common.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// 0x8000-0x9FFF in reference counted pages, kept by ppu while lines are drawn on other thread
+// Snapshot shares pages with the copy, write to a shared page gives the copy its own one
+// so a snapshot never changes
+class vram_copy
+{
+  public:
+    static constexpr uint16_t VRAM_ADDR{0x8000};
+    static constexpr size_t PAGE_SIZE{0x100};
+    static constexpr size_t PAGE_COUNT{0x2000 / PAGE_SIZE};
+    using page = std::array<uint8_t, PAGE_SIZE>;
+    using pages = std::array<std::shared_ptr<page>, PAGE_COUNT>;
+
+    // Whole VRAM is read again
+    void load(rw_device &rw);
+
+    void write(uint16_t addr, uint8_t value);
+
+    // Lines without VRAM writes between them share the same snapshot
+    std::shared_ptr<pages const> snapshot() const
+    {
+        return m_pages;
+    }
+
+    static uint8_t read(pages const &vram, uint16_t addr)
+    {
+        return (*vram[(addr - VRAM_ADDR) / PAGE_SIZE])[(addr - VRAM_ADDR) % PAGE_SIZE];
+    }
+
+  private:
+    std::shared_ptr<pages> m_pages;
+};
+
+#endif
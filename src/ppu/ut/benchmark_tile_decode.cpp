@@ -0,0 +1,66 @@
+#include "../src/pixel_fifo.hpp"
+#include "../src/tile_decode.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+// Whole tile data area, as tile cache decodes it
+constexpr size_t LINES{384 * 8};
+constexpr int ROUNDS{2000};
+
+uint8_t g_sink{};
+
+template <typename F>
+void measure(char const *name, F decode)
+{
+    std::vector<uint8_t> data(LINES * 2);
+    std::mt19937 rng{1};
+    for (auto &b : data)
+        b = static_cast<uint8_t>(rng());
+    std::vector<uint8_t> ids(LINES * 8);
+
+    auto const start = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; ++r)
+    {
+        decode(data.data(), LINES, ids.data());
+        g_sink ^= ids[r % ids.size()];
+    }
+    std::chrono::duration<double, std::nano> const elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << std::left << std::setw(10) << name << std::fixed << std::setprecision(2)
+              << elapsed.count() / (double(ROUNDS) * LINES) << " ns/line\n";
+}
+
+void decode_reference(uint8_t const *data, size_t lines, uint8_t *ids)
+{
+    for (size_t i = 0; i < lines; ++i)
+    {
+        uint16_t const line = static_cast<uint16_t>(data[i * 2 + 1] << 8 | data[i * 2]);
+        auto const result = convert_tile_line_to_color_ids(line);
+        std::memcpy(ids + i * 8, result.data(), 8);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    measure("reference", decode_reference);
+    measure("scalar", decode_tile_lines_scalar);
+#ifdef TILE_DECODE_BMI2
+    measure("bmi2", decode_tile_lines_bmi2);
+#endif
+#ifdef TILE_DECODE_SSE2
+    measure("sse2", decode_tile_lines_sse2);
+#endif
+#ifdef TILE_DECODE_AVX2
+    measure("avx2", decode_tile_lines_avx2);
+#endif
+    return g_sink == 0xFF ? 1 : 0;
+}
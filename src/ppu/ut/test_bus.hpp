@@ -0,0 +1,71 @@
+#ifndef TEST_BUS_HPP
+#define TEST_BUS_HPP
+
+#include <common.hpp>
+#include <ppu.hpp>
+#include <array>
+#include <vector>
+
+// Plain memory, counts writes done by ppu
+struct test_bus : public rw_device
+{
+    std::array<uint8_t, 0x10000> m_mem{};
+    std::array<int, 0x10000> m_writes{};
+
+    uint8_t read(uint16_t addr, device, bool) override
+    {
+        return m_mem[addr];
+    }
+
+    void write(uint16_t addr, uint8_t data, device, bool) override
+    {
+        m_mem[addr] = data;
+        ++m_writes[addr];
+    }
+};
+
+// Counts frames and keeps the last one
+struct frame_counter : public drawing_device
+{
+    int m_frames{};
+    std::vector<color> m_frame;
+
+    void after_frame(frame_view frame) override
+    {
+        m_frame.assign(frame.begin(), frame.end());
+        ++m_frames;
+    }
+};
+
+// Ppu drawing from test_bus, Base is ::testing::Test or ::testing::TestWithParam
+template <typename Base>
+struct ppu_fixture : public Base
+{
+    test_bus m_bus;
+    frame_counter m_screen;
+    ppu m_ppu{m_bus, m_screen};
+
+    // CPU writes register or OAM
+    void write(uint16_t addr, uint8_t value)
+    {
+        m_bus.m_mem[addr] = value;
+        if (addr < 0xFF00)
+            m_ppu.oam_written(addr, value);
+        else
+            m_ppu.register_written(addr, value);
+    }
+
+    void write_vram(uint16_t addr, uint8_t value)
+    {
+        m_bus.m_mem[addr] = value;
+        m_ppu.vram_written(addr);
+    }
+
+    void run(int dots)
+    {
+        for (int i = 0; i < dots; ++i)
+            m_ppu.dot();
+    }
+};
+
+#endif
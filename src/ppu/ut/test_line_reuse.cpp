@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <ppu.hpp>
+#include "test_bus.hpp"
+
+#include <vector>
+
+namespace
+{
+
+constexpr int FRAME_DOTS{456 * 154};
+constexpr color BLACK{make_color(0, 0, 0)};
+constexpr color WHITE{make_color(255, 255, 255)};
+
+// Background of tile 0 at 0x9800, tile 1 is black
+struct line_reuse_tests : public ppu_fixture<::testing::TestWithParam<renderer>>
+{
+    line_reuse_tests()
+    {
+        m_ppu.set_renderer(GetParam());
+        for (uint16_t b = 0; b < 16; ++b)
+            write_vram(0x8010 + b, 0xFF);
+        write(0xFF47, 0xE4);
+        write(0xFF40, 0x91);
+        run_frame();
+    }
+
+    void run_frame()
+    {
+        run(FRAME_DOTS);
+    }
+
+    color pixel(size_t x, size_t y) const
+    {
+        return m_screen.m_frame[y * SCREEN_WIDTH + x];
+    }
+};
+
+} // namespace
+
+TEST_P(line_reuse_tests, tile_map_write_is_drawn)
+{
+    ASSERT_EQ(pixel(0, 8), WHITE);
+    write_vram(0x9800 + 32, 1);
+    run_frame();
+    ASSERT_EQ(pixel(0, 8), BLACK);
+    ASSERT_EQ(pixel(0, 15), BLACK);
+    ASSERT_EQ(pixel(0, 7), WHITE);
+    ASSERT_EQ(pixel(0, 16), WHITE);
+}
+
+TEST_P(line_reuse_tests, tile_data_write_is_drawn)
+{
+    write_vram(0x8000, 0xFF);
+    run_frame();
+    ASSERT_NE(pixel(0, 0), WHITE);
+    ASSERT_EQ(pixel(0, 8), pixel(0, 0));
+    ASSERT_EQ(pixel(0, 1), WHITE);
+}
+
+TEST_P(line_reuse_tests, palette_write_is_drawn)
+{
+    write(0xFF47, 0xE7);
+    run_frame();
+    ASSERT_EQ(pixel(0, 0), BLACK);
+}
+
+TEST_P(line_reuse_tests, new_frame_buffer_gets_whole_frame)
+{
+    write_vram(0x9800, 1);
+    run_frame();
+
+    std::vector<color> buffer(SCREEN_WIDTH * SCREEN_HEIGHT);
+    m_ppu.set_frame_buffer(frame_buffer{buffer.data(), buffer.size()});
+    run_frame();
+    ASSERT_EQ(m_screen.m_frame, buffer);
+    ASSERT_EQ(buffer[0], BLACK);
+    ASSERT_EQ(buffer.back(), WHITE);
+}
+
+INSTANTIATE_TEST_SUITE_P(renderers, line_reuse_tests, ::testing::Values(renderer::SCANLINE, renderer::THREADED));
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "../src/oam_scan.hpp"
+
+#include <random>
+
+namespace
+{
+
+bool same(std::array<sprite, 10> const &l, std::array<sprite, 10> const &r, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        if (l[i].m_y_pos != r[i].m_y_pos || l[i].m_x_pos != r[i].m_x_pos || l[i].m_tile_index != r[i].m_tile_index ||
+            l[i].m_flags != r[i].m_flags)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(oam_scan_tests, sprite_covers_its_height)
+{
+    oam_mirror oam;
+    oam.write(0xFE00, 16); // lines 0-7, or 0-15
+    oam.write(0xFE01, 50);
+    std::array<sprite, 10> out;
+
+    for (uint8_t height : {8, 16})
+    {
+        for (int line = 0; line < 154; ++line)
+        {
+            uint8_t const count = select_sprites(oam, line, height, out);
+            ASSERT_EQ(count, line < height ? 1 : 0) << "line " << line;
+        }
+    }
+    ASSERT_EQ(out[0].m_x_pos, 50);
+}
+
+TEST(oam_scan_tests, at_most_ten_in_oam_order)
+{
+    oam_mirror oam;
+    for (uint16_t i = 0; i < oam_mirror::SPRITES; ++i)
+    {
+        oam.write(0xFE00 + i * 4, 20);
+        oam.write(0xFE01 + i * 4, static_cast<uint8_t>(i));
+    }
+    std::array<sprite, 10> out;
+    ASSERT_EQ(select_sprites(oam, 4, 8, out), 10);
+    for (uint8_t i = 0; i < 10; ++i)
+        ASSERT_EQ(out[i].m_x_pos, i);
+}
+
+TEST(oam_scan_tests, same_as_scalar)
+{
+    std::mt19937 rng{7};
+    for (int round = 0; round < 200; ++round)
+    {
+        oam_mirror oam;
+        for (uint16_t addr = 0xFE00; addr < 0xFEA0; ++addr)
+            oam.write(addr, static_cast<uint8_t>(round % 2 ? rng() % 176 : rng()));
+
+        for (uint8_t height : {8, 16})
+        {
+            for (int line = 0; line < 256; ++line)
+            {
+                std::array<sprite, 10> simd, scalar;
+                uint8_t const count = select_sprites(oam, line, height, simd);
+                ASSERT_EQ(count, select_sprites_scalar(oam, line, height, scalar));
+                ASSERT_TRUE(same(simd, scalar, count));
+            }
+        }
+    }
+}
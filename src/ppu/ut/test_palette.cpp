@@ -0,0 +1,22 @@
+#include <gtest/gtest.h>
+
+#include "../src/pixel_fifo.hpp"
+
+TEST(palette_tests, colors_follow_register_bits)
+{
+    // id 0 -> shade 3, id 1 -> shade 2, id 2 -> shade 1, id 3 -> shade 0
+    auto const inverted = make_palette_colors(0b00'01'10'11);
+    auto const identity = make_palette_colors(0b11'10'01'00);
+    for (int id = 0; id < 4; ++id)
+        EXPECT_EQ(inverted[id], identity[3 - id]);
+
+    EXPECT_EQ(identity[0], make_color(255, 255, 255));
+    EXPECT_EQ(identity[3], make_color(0, 0, 0));
+}
+
+TEST(palette_tests, pixel_color_index_selects_palette)
+{
+    EXPECT_EQ(pixel_color_index(3), 3);
+    EXPECT_EQ(pixel_color_index(PIXEL_SPRITE | 2), 10);
+    EXPECT_EQ(pixel_color_index(PIXEL_SPRITE | PIXEL_PALETTE | PIXEL_PRIORITY | 1), 13);
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <ppu.hpp>
+#include "test_bus.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr int LINE_DOTS{456};
+constexpr int FRAME_DOTS{LINE_DOTS * 154};
+
+struct ppu_modes_tests : public ppu_fixture<::testing::Test>
+{
+    uint8_t mode() const
+    {
+        return m_bus.m_mem[0xFF41] & 0x03;
+    }
+
+    // dots of mode 3 in the line which starts now
+    int drawing_dots()
+    {
+        run(80);
+        int dots = 0;
+        for (; mode() == 3; ++dots)
+            m_ppu.dot();
+        run(LINE_DOTS - 80 - dots);
+        return dots;
+    }
+};
+
+} // namespace
+
+TEST_F(ppu_modes_tests, frame_has_exact_length)
+{
+    write(0xFF40, 0x91);
+    run(FRAME_DOTS - 1);
+    ASSERT_EQ(m_screen.m_frames, 0);
+    run(1);
+    ASSERT_EQ(m_screen.m_frames, 1);
+    run(FRAME_DOTS * 3);
+    ASSERT_EQ(m_screen.m_frames, 4);
+}
+
+TEST_F(ppu_modes_tests, registers_are_written_only_on_change)
+{
+    write(0xFF40, 0x91);
+    m_bus.m_writes.fill(0);
+    run(FRAME_DOTS);
+
+    // LY once per line, STAT on mode changes: 3 per visible line, 1 for VBlank
+    ASSERT_EQ(m_bus.m_writes[0xFF44], 154);
+    ASSERT_LE(m_bus.m_writes[0xFF41], 144 * 3 + 1 + 2);
+}
+
+TEST_F(ppu_modes_tests, modes_follow_line_timing)
+{
+    write(0xFF40, 0x91);
+    std::vector<uint8_t> modes;
+    for (int i = 0; i < LINE_DOTS; ++i)
+    {
+        modes.push_back(mode());
+        m_ppu.dot();
+    }
+    ASSERT_EQ(m_bus.m_mem[0xFF44], 1);
+
+    ASSERT_EQ(std::count(modes.begin(), modes.begin() + 80, 2), 80);
+    ASSERT_EQ(std::count(modes.begin() + 80, modes.begin() + 80 + 172, 3), 172);
+    ASSERT_EQ(std::count(modes.begin() + 80 + 172, modes.end(), 0), LINE_DOTS - 80 - 172);
+
+    run(LINE_DOTS * 143);
+    ASSERT_EQ(m_bus.m_mem[0xFF44], 144);
+    ASSERT_EQ(mode(), 1);
+    ASSERT_TRUE(m_bus.m_mem[0xFF0F] & 0x01);
+}
+
+TEST_F(ppu_modes_tests, drawing_length_depends_on_scroll)
+{
+    write(0xFF40, 0x91);
+    ASSERT_EQ(drawing_dots(), 172);
+
+    write(0xFF43, 3);
+    ASSERT_EQ(drawing_dots(), 175);
+}
+
+TEST_F(ppu_modes_tests, sprites_add_penalty)
+{
+    // sprite with X 8 waits 5 dots for its tile and 6 for itself, the one with X 9 only 6, X 0 always 11
+    write(0xFF40, 0x93);
+    std::array<uint8_t, 12> const oam{20, 8, 0, 0, 20, 9, 0, 0, 20, 0, 0, 0};
+    for (uint16_t i = 0; i < oam.size(); ++i)
+        write(0xFE00 + i, oam[i]);
+    run(LINE_DOTS * 4);
+    ASSERT_EQ(m_bus.m_mem[0xFF44], 4);
+    ASSERT_EQ(drawing_dots(), 172 + 5 + 6 + 6 + 11);
+}
+
+TEST_F(ppu_modes_tests, lyc_interrupt_is_raised_once_per_frame)
+{
+    write(0xFF45, 10);
+    write(0xFF41, 0x40);
+    write(0xFF40, 0x91);
+
+    int interrupts = 0;
+    for (int i = 0; i < FRAME_DOTS * 2; ++i)
+    {
+        m_ppu.dot();
+        if (m_bus.m_mem[0xFF0F] & 0x02)
+        {
+            ++interrupts;
+            m_bus.m_mem[0xFF0F] = 0;
+            ASSERT_EQ(m_bus.m_mem[0xFF44], 10);
+            ASSERT_TRUE(m_bus.m_mem[0xFF41] & 0x04);
+        }
+    }
+    ASSERT_EQ(interrupts, 2);
+    ASSERT_FALSE(m_bus.m_mem[0xFF41] & 0x04);
+}
+
+TEST_F(ppu_modes_tests, cpu_cannot_change_read_only_bits)
+{
+    write(0xFF40, 0x91);
+    run(100);
+    write(0xFF41, 0x00);
+    write(0xFF44, 0x55);
+    ASSERT_EQ(mode(), 3);
+    ASSERT_EQ(m_bus.m_mem[0xFF44], 0);
+}
+
+TEST_F(ppu_modes_tests, lcd_off_resets_line)
+{
+    write(0xFF40, 0x91);
+    run(LINE_DOTS * 10 + 100);
+    write(0xFF40, 0x11);
+    ASSERT_EQ(m_bus.m_mem[0xFF44], 0);
+    ASSERT_EQ(mode(), 0);
+    run(FRAME_DOTS);
+    ASSERT_EQ(m_screen.m_frames, 0);
+}
+
+TEST_F(ppu_modes_tests, skipped_frames_keep_timing)
+{
+    test_bus bus;
+    frame_counter screen;
+    ppu skipping{bus, screen};
+    skipping.set_frame_skip(LOGIC_ONLY);
+
+    // sprites, scroll and window change mode 3 length
+    std::array<uint8_t, 8> const oam{20, 8, 0, 0, 40, 30, 0, 0};
+    for (uint16_t i = 0; i < oam.size(); ++i)
+    {
+        write(0xFE00 + i, oam[i]);
+        skipping.oam_written(0xFE00 + i, oam[i]);
+    }
+    for (auto const &[addr, value] : {std::pair<uint16_t, uint8_t>{0xFF43, 5}, {0xFF4A, 50}, {0xFF4B, 60}, {0xFF40, 0xB3}})
+    {
+        write(addr, value);
+        bus.m_mem[addr] = value;
+        skipping.register_written(addr, value);
+    }
+
+    for (int i = 0; i < FRAME_DOTS * 2; ++i)
+    {
+        m_ppu.dot();
+        skipping.dot();
+        ASSERT_EQ(bus.m_mem[0xFF41], m_bus.m_mem[0xFF41]) << "dot " << i;
+        ASSERT_EQ(bus.m_mem[0xFF44], m_bus.m_mem[0xFF44]) << "dot " << i;
+        ASSERT_EQ(bus.m_mem[0xFF0F], m_bus.m_mem[0xFF0F]) << "dot " << i;
+    }
+    ASSERT_EQ(m_screen.m_frames, 2);
+    ASSERT_EQ(screen.m_frames, 0);
+}
+
+TEST_F(ppu_modes_tests, one_frame_is_drawn_then_skip_count_is_skipped)
+{
+    m_ppu.set_frame_skip(2);
+    write(0xFF40, 0x91);
+    run(FRAME_DOTS);
+    ASSERT_EQ(m_screen.m_frames, 1);
+    run(FRAME_DOTS * 2);
+    ASSERT_EQ(m_screen.m_frames, 1);
+    run(FRAME_DOTS * 3);
+    ASSERT_EQ(m_screen.m_frames, 2);
+
+    m_ppu.set_frame_skip(0);
+    run(FRAME_DOTS * 3);
+    ASSERT_EQ(m_screen.m_frames, 5);
+}
+
+TEST_F(ppu_modes_tests, loaded_state_keeps_skip_phase)
+{
+    // first frame is drawn, the second one is being skipped
+    m_ppu.set_frame_skip(2);
+    write(0xFF40, 0x91);
+    run(FRAME_DOTS + FRAME_DOTS / 2);
+    ASSERT_EQ(m_screen.m_frames, 1);
+
+    test_bus bus{m_bus};
+    frame_counter screen;
+    ppu loaded{bus, screen};
+    loaded.set_frame_skip(2);
+    loaded.load_state(m_ppu.save_state());
+
+    for (int i = 0; i < FRAME_DOTS * 6; ++i)
+    {
+        m_ppu.dot();
+        loaded.dot();
+    }
+    ASSERT_EQ(m_screen.m_frames, 3);
+    ASSERT_EQ(screen.m_frames, 2);
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <ppu.hpp>
+
+TEST(ppu_registers_tests, lcdc_selects_maps_and_tile_data)
+{
+    ppu_registers r;
+    r.write(0xFF40, 0x91);
+    EXPECT_EQ(r.m_background_map_addr, 0x9800);
+    EXPECT_EQ(r.m_window_map_addr, 0x9800);
+    EXPECT_FALSE(r.m_signed_tile_index);
+    EXPECT_EQ(r.m_sprite_height, 8);
+
+    r.write(0xFF40, 0xCC);
+    EXPECT_EQ(r.m_background_map_addr, 0x9C00);
+    EXPECT_EQ(r.m_window_map_addr, 0x9C00);
+    EXPECT_TRUE(r.m_signed_tile_index);
+    EXPECT_EQ(r.m_sprite_height, 16);
+}
+
+TEST(ppu_registers_tests, tile_index_is_signed_in_0x8800_mode)
+{
+    ppu_registers r;
+    r.write(0xFF40, 0x80);
+    EXPECT_EQ(r.tile_addr(0), 0x9000);
+    EXPECT_EQ(r.tile_addr(127), 0x97F0);
+    EXPECT_EQ(r.tile_addr(128), 0x8800);
+    EXPECT_EQ(r.tile_addr(255), 0x8FF0);
+
+    r.write(0xFF40, 0x90);
+    EXPECT_EQ(r.tile_addr(0), 0x8000);
+    EXPECT_EQ(r.tile_addr(255), 0x8FF0);
+}
+
+TEST(ppu_registers_tests, cpu_writes_only_writable_bits)
+{
+    ppu_registers r;
+    r.m_stat = 0x87;
+    r.m_ly = 42;
+    r.write(0xFF41, 0x7C);
+    r.write(0xFF44, 0);
+    EXPECT_EQ(r.m_stat, 0xFF);
+    EXPECT_EQ(r.m_ly, 42);
+
+    r.write(0xFF4B, 7);
+    r.write(0xFF4A, 9);
+    EXPECT_EQ(r.m_wx, 7);
+    EXPECT_EQ(r.m_wy, 9);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <ppu.hpp>
+#include "test_bus.hpp"
+
+#include <vector>
+
+namespace
+{
+
+constexpr int FRAME_DOTS{456 * 154};
+constexpr color BLACK{make_color(0, 0, 0)};
+
+// Draws one sprite at the top left corner of the screen
+struct sprite_tests : public ppu_fixture<::testing::TestWithParam<renderer>>
+{
+    sprite_tests()
+    {
+        m_ppu.set_renderer(GetParam());
+
+        // tile 1 and tile 2 row r: only pixel r is set, tile 3: only pixel 7
+        for (uint16_t r = 0; r < 8; ++r)
+        {
+            write_vram(0x8010 + r * 2, 0x80 >> r);
+            write_vram(0x8011 + r * 2, 0x80 >> r);
+            write_vram(0x8020 + r * 2, 0x80 >> r);
+            write_vram(0x8021 + r * 2, 0x80 >> r);
+            write_vram(0x8030 + r * 2, 0x01);
+            write_vram(0x8031 + r * 2, 0x01);
+        }
+        write(0xFF47, 0xE4);
+        write(0xFF48, 0xE4);
+    }
+
+    // Column of the only black pixel of each of the first lines, -1 if there is none
+    std::vector<int> draw(uint8_t tile, uint8_t flags, bool tall)
+    {
+        write(0xFE00, 16);
+        write(0xFE01, 8);
+        write(0xFE02, tile);
+        write(0xFE03, flags);
+        write(0xFF40, tall ? 0x97 : 0x93);
+        run(FRAME_DOTS);
+
+        std::vector<int> result;
+        for (size_t y = 0; y < (tall ? 16u : 8u); ++y)
+        {
+            int column = -1;
+            for (size_t x = 0; x < 8; ++x)
+            {
+                if (m_screen.m_frame[y * SCREEN_WIDTH + x] == BLACK)
+                    column = static_cast<int>(x);
+            }
+            result.push_back(column);
+        }
+        return result;
+    }
+};
+
+} // namespace
+
+TEST_P(sprite_tests, normal)
+{
+    ASSERT_EQ(draw(1, 0x00, false), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+}
+
+TEST_P(sprite_tests, x_flip)
+{
+    ASSERT_EQ(draw(1, 0x20, false), (std::vector<int>{7, 6, 5, 4, 3, 2, 1, 0}));
+}
+
+TEST_P(sprite_tests, y_flip)
+{
+    ASSERT_EQ(draw(1, 0x40, false), (std::vector<int>{7, 6, 5, 4, 3, 2, 1, 0}));
+}
+
+TEST_P(sprite_tests, both_flips)
+{
+    ASSERT_EQ(draw(1, 0x60, false), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+}
+
+TEST_P(sprite_tests, tall_uses_even_tile_first)
+{
+    // tile index 3 draws tiles 2 and 3
+    ASSERT_EQ(draw(3, 0x00, true), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7}));
+}
+
+TEST_P(sprite_tests, tall_y_flip_swaps_tiles)
+{
+    ASSERT_EQ(draw(2, 0x40, true), (std::vector<int>{7, 7, 7, 7, 7, 7, 7, 7, 7, 6, 5, 4, 3, 2, 1, 0}));
+}
+
+INSTANTIATE_TEST_SUITE_P(renderers, sprite_tests, ::testing::Values(renderer::FIFO, renderer::SCANLINE));
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include "../src/pixel_fifo.hpp"
+#include "../src/tile_decode.hpp"
+
+#include <vector>
+
+namespace
+{
+
+using decoder = void (*)(uint8_t const *, size_t, uint8_t *);
+
+// Every pair of bytes as one line, lines are decoded in one call
+void expect_all_lines_equal(decoder decode)
+{
+    std::vector<uint8_t> data;
+    data.reserve(0x10000 * 2);
+    for (uint32_t line = 0; line <= 0xFFFF; ++line)
+    {
+        data.push_back(static_cast<uint8_t>(line));      // low byte is read first
+        data.push_back(static_cast<uint8_t>(line >> 8)); // high byte
+    }
+
+    // odd count, wide paths also leave remaining lines to the single line decoder
+    size_t const lines = 0x10000 - 3;
+    std::vector<uint8_t> ids(lines * 8);
+    decode(data.data(), lines, ids.data());
+
+    for (uint32_t line = 0; line < lines; ++line)
+    {
+        auto const expected = convert_tile_line_to_color_ids(static_cast<uint16_t>(line));
+        for (int i = 0; i < 8; ++i)
+            ASSERT_EQ(ids[line * 8 + i], expected[i]) << "line " << line << " pixel " << i;
+    }
+}
+
+} // namespace
+
+TEST(tile_decode_tests, single_line)
+{
+    for (uint32_t line = 0; line <= 0xFFFF; ++line)
+    {
+        uint8_t ids[8];
+        decode_tile_line(static_cast<uint8_t>(line), static_cast<uint8_t>(line >> 8), ids);
+        auto const expected = convert_tile_line_to_color_ids(static_cast<uint16_t>(line));
+        for (int i = 0; i < 8; ++i)
+            ASSERT_EQ(ids[i], expected[i]) << "line " << line << " pixel " << i;
+    }
+}
+
+TEST(tile_decode_tests, default_decoder)
+{
+    expect_all_lines_equal(decode_tile_lines);
+}
+
+TEST(tile_decode_tests, scalar)
+{
+    expect_all_lines_equal(decode_tile_lines_scalar);
+}
+
+#ifdef TILE_DECODE_SSE2
+TEST(tile_decode_tests, sse2)
+{
+    expect_all_lines_equal(decode_tile_lines_sse2);
+}
+#endif
+
+#ifdef TILE_DECODE_AVX2
+TEST(tile_decode_tests, avx2)
+{
+    expect_all_lines_equal(decode_tile_lines_avx2);
+}
+#endif
+
+#ifdef TILE_DECODE_BMI2
+TEST(tile_decode_tests, bmi2)
+{
+    expect_all_lines_equal(decode_tile_lines_bmi2);
+}
+#endif
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include "../src/vram_copy.hpp"
+#include "test_bus.hpp"
+
+TEST(vram_copy_tests, snapshot_does_not_see_later_writes)
+{
+    test_bus bus;
+    bus.m_mem[0x8000] = 1;
+    bus.m_mem[0x9FFF] = 2;
+
+    vram_copy vram;
+    vram.load(bus);
+    auto const before = vram.snapshot();
+    vram.write(0x8000, 3);
+    auto const after = vram.snapshot();
+
+    ASSERT_EQ(vram_copy::read(*before, 0x8000), 1);
+    ASSERT_EQ(vram_copy::read(*after, 0x8000), 3);
+    ASSERT_EQ(vram_copy::read(*after, 0x9FFF), 2);
+
+    // only the written page is copied
+    ASSERT_NE((*before)[0], (*after)[0]);
+    ASSERT_EQ((*before)[1], (*after)[1]);
+}
+
+TEST(vram_copy_tests, unshared_page_is_written_in_place)
+{
+    test_bus bus;
+    vram_copy vram;
+    vram.load(bus);
+    auto const page = (*vram.snapshot())[0].get();
+
+    vram.write(0x8010, 5);
+    vram.write(0x8011, 6);
+    ASSERT_EQ((*vram.snapshot())[0].get(), page);
+    ASSERT_EQ(vram_copy::read(*vram.snapshot(), 0x8011), 6);
+}
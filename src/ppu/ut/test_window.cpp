@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <ppu.hpp>
+#include "test_bus.hpp"
+
+#include <string>
+
+namespace
+{
+
+constexpr int LINE_DOTS{456};
+constexpr int FRAME_DOTS{LINE_DOTS * 154};
+constexpr color BLACK{make_color(0, 0, 0)};
+
+// Background is white, window map at 0x9C00
+struct window_tests : public ppu_fixture<::testing::TestWithParam<renderer>>
+{
+    window_tests()
+    {
+        m_ppu.set_renderer(GetParam());
+
+        // tile 1 black, tile 2 black on its right half
+        for (uint16_t b = 0; b < 16; ++b)
+        {
+            write_vram(0x8010 + b, 0xFF);
+            write_vram(0x8020 + b, 0x0F);
+        }
+        write(0xFF47, 0xE4);
+    }
+
+    // '#' for black pixel, '.' for others
+    std::string line(size_t y, size_t width = SCREEN_WIDTH) const
+    {
+        std::string result;
+        for (size_t x = 0; x < width; ++x)
+            result += m_screen.m_frame[y * SCREEN_WIDTH + x] == BLACK ? '#' : '.';
+        return result;
+    }
+};
+
+} // namespace
+
+TEST_P(window_tests, starts_at_wx_and_wy)
+{
+    for (uint16_t t = 0; t < 32 * 32; ++t)
+        write_vram(0x9C00 + t, 1);
+    write(0xFF4A, 10);
+    write(0xFF4B, 7 + 20);
+    write(0xFF40, 0xF1);
+    run(FRAME_DOTS);
+
+    ASSERT_EQ(line(9), std::string(SCREEN_WIDTH, '.'));
+    ASSERT_EQ(line(10), std::string(20, '.') + std::string(SCREEN_WIDTH - 20, '#'));
+    ASSERT_EQ(line(143), line(10));
+}
+
+TEST_P(window_tests, pixels_left_of_screen_are_skipped)
+{
+    write_vram(0x9C00, 2);
+    write(0xFF4A, 0);
+    write(0xFF4B, 3);
+    write(0xFF40, 0xF1);
+    run(FRAME_DOTS);
+
+    ASSERT_EQ(line(0, 12), "####........");
+}
+
+TEST_P(window_tests, hidden_lines_are_not_counted)
+{
+    // first window tile row is black, the rest is white
+    for (uint16_t t = 0; t < 32; ++t)
+        write_vram(0x9C00 + t, 1);
+    write(0xFF4A, 0);
+    write(0xFF4B, 7);
+    write(0xFF40, 0xF1);
+
+    run(LINE_DOTS * 4);
+    write(0xFF4B, 200);
+    run(LINE_DOTS * 96);
+    write(0xFF4B, 7);
+    run(FRAME_DOTS - LINE_DOTS * 100);
+
+    ASSERT_EQ(line(3, 8), "########");
+    ASSERT_EQ(line(4, 8), "........");
+    ASSERT_EQ(line(100, 8), "########");
+    ASSERT_EQ(line(103, 8), "########");
+    ASSERT_EQ(line(104, 8), "........");
+}
+
+INSTANTIATE_TEST_SUITE_P(renderers, window_tests, ::testing::Values(renderer::FIFO, renderer::SCANLINE));
@@ -0,0 +1,28 @@
+#ifndef FRAME_EXCHANGE_HPP
+#define FRAME_EXCHANGE_HPP
+
+#include <common.hpp>
+#include <triple_buffer.hpp>
+#include <array>
+#include <optional>
+
+// Drawing device for emulation on its own thread, presenter on another one takes the newest frame
+// Completed frames go through triple buffer, so a slow presenter never stalls emulation,
+// frames it does not take in time are skipped
+class frame_exchange : public drawing_device
+{
+  public:
+    // Emulation thread
+    void after_frame(frame_view frame) override;
+
+    // Presenter thread, frame completed since the last take, valid until the next take
+    std::optional<frame_view> take_frame();
+
+    // Presenter thread, waits until there is a frame to take
+    frame_view wait_frame();
+
+  private:
+    triple_buffer<std::array<color, SCREEN_WIDTH * SCREEN_HEIGHT>> m_frames;
+};
+
+#endif
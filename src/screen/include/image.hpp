@@ -0,0 +1,16 @@
+#ifndef IMAGE_HPP
+#define IMAGE_HPP
+
+#include <common.hpp>
+#include <filesystem>
+
+enum class image_format
+{
+    PPM, // binary P6
+    PNG  // 8 bit RGB, stored without compression
+};
+
+// Throws std::runtime_error when file cannot be written
+void write_image(std::filesystem::path const &file, frame_view frame, image_format format);
+
+#endif
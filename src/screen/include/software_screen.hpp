@@ -0,0 +1,34 @@
+#ifndef SOFTWARE_SCREEN_HPP
+#define SOFTWARE_SCREEN_HPP
+
+#include <common.hpp>
+#include <image.hpp>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+
+// Drawing device without window, keeps the last completed frame
+// Frame is copied into the back buffer which then becomes the front one, so the front one
+// stays whole while the next frame is drawn
+class software_screen : public drawing_device
+{
+  public:
+    // With dump directory every completed frame is written there as frame_<number>.ppm / .png
+    explicit software_screen(std::filesystem::path dump_directory = {}, image_format format = image_format::PPM);
+
+    void after_frame(frame_view frame) override;
+
+    // Blank until the first frame is completed
+    frame_view last_frame() const;
+    uint64_t frames() const;
+
+  private:
+    std::array<std::array<color, SCREEN_WIDTH * SCREEN_HEIGHT>, 2> m_buffers{};
+    size_t m_front{};
+    uint64_t m_frames{};
+
+    std::filesystem::path m_dump_directory;
+    image_format m_format;
+};
+
+#endif
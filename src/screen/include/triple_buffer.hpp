@@ -0,0 +1,60 @@
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hands the newest value from one writer thread to one reader thread, without locks
+// Writer and reader own a buffer each, the third one in the middle is exchanged by an atomic swap,
+// so neither side waits for the other and a value not taken in time is replaced by the newer one
+template <typename T> class triple_buffer
+{
+  public:
+    // Writer fills back, publish makes it the newest value and gives writer another buffer
+    T &back()
+    {
+        return m_buffers[m_back];
+    }
+
+    void publish()
+    {
+        m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX;
+        m_middle.notify_one();
+    }
+
+    // True when a value was published since the last take, front is that value then
+    bool take()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    // Reader sleeps until a value is published, only the reader waits and only when there is nothing new
+    void wait() const
+    {
+        for (uint8_t middle = m_middle.load(std::memory_order_relaxed); !(middle & FRESH);
+             middle = m_middle.load(std::memory_order_relaxed))
+            m_middle.wait(middle, std::memory_order_relaxed);
+    }
+
+    T const &front() const
+    {
+        return m_buffers[m_front];
+    }
+
+  private:
+    static constexpr uint8_t INDEX{0x03};
+    static constexpr uint8_t FRESH{0x04};
+
+    std::array<T, 3> m_buffers{};
+
+    // padded like the indexes of spsc_queue, only the middle one is touched by both sides
+    alignas(64) uint8_t m_back{0};
+    alignas(64) std::atomic<uint8_t> m_middle{1};
+    alignas(64) uint8_t m_front{2};
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef VIDEO_RECORDER_HPP
+#define VIDEO_RECORDER_HPP
+
+#include <common.hpp>
+#include <spsc_queue.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+enum class video_format
+{
+    Y4M, // raw YUV 4:4:4, for piping to an encoder
+    GIF  // animated, the four shades are its color table
+};
+
+class video_encoder;
+
+// Drawing device which records completed frames to a video file
+// Emulation thread only copies the frame into a free slot of a ring allocated up front, a background thread encodes
+// and writes it, so emulation never waits for the disk. Frame which finds the ring full is dropped and counted.
+class video_recorder : public drawing_device
+{
+  public:
+    // Throws std::runtime_error when file cannot be created
+    video_recorder(std::filesystem::path const &file, video_format format);
+    ~video_recorder();
+
+    video_recorder(video_recorder const &) = delete;
+    video_recorder &operator=(video_recorder const &) = delete;
+
+    void after_frame(frame_view frame) override;
+
+    // Encodes frames still in the ring and closes the file, later frames are dropped
+    // Throws std::runtime_error when writing failed
+    void finish();
+
+    // Written to the file, counted by the encoder thread
+    uint64_t recorded_frames() const;
+    uint64_t dropped_frames() const;
+
+  private:
+    // Frame marked as last stops the encoder
+    struct job
+    {
+        std::array<color, SCREEN_WIDTH * SCREEN_HEIGHT> m_frame{};
+        bool m_last{};
+    };
+
+    // about a second of frames which can wait for the encoder
+    static constexpr size_t RING_FRAMES{64};
+
+    std::filesystem::path m_path;
+    std::ofstream m_file;
+    std::unique_ptr<video_encoder> m_encoder;
+
+    // megabytes, so it is not a part of the object
+    std::unique_ptr<spsc_queue<job, RING_FRAMES>> m_ring;
+
+    std::atomic<uint64_t> m_recorded{};
+    std::atomic<uint64_t> m_dropped{};
+    std::atomic<bool> m_failed{};
+    bool m_finished{};
+
+    std::thread m_thread;
+
+    void work();
+};
+
+#endif
@@ -0,0 +1,22 @@
+#include <frame_exchange.hpp>
+#include <algorithm>
+
+void frame_exchange::after_frame(frame_view frame)
+{
+    std::copy(frame.begin(), frame.end(), m_frames.back().begin());
+    m_frames.publish();
+}
+
+std::optional<frame_view> frame_exchange::take_frame()
+{
+    if (!m_frames.take())
+        return std::nullopt;
+    return frame_view{m_frames.front()};
+}
+
+frame_view frame_exchange::wait_frame()
+{
+    m_frames.wait();
+    m_frames.take();
+    return frame_view{m_frames.front()};
+}
@@ -0,0 +1,127 @@
+#include <image.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Rows of RGB bytes, alpha is dropped
+std::vector<uint8_t> rgb_rows(frame_view frame, size_t row_prefix)
+{
+    std::vector<uint8_t> result;
+    result.reserve(SCREEN_HEIGHT * (row_prefix + SCREEN_WIDTH * 3));
+    for (size_t y = 0; y < SCREEN_HEIGHT; ++y)
+    {
+        result.insert(result.end(), row_prefix, 0);
+        for (size_t x = 0; x < SCREEN_WIDTH; ++x)
+        {
+            color const c = frame[y * SCREEN_WIDTH + x];
+            result.insert(result.end(), {color_red(c), color_green(c), color_blue(c)});
+        }
+    }
+    return result;
+}
+
+void write_ppm(std::ofstream &ofs, frame_view frame)
+{
+    ofs << "P6\n" << SCREEN_WIDTH << ' ' << SCREEN_HEIGHT << "\n255\n";
+    auto const pixels = rgb_rows(frame, 0);
+    ofs.write(reinterpret_cast<char const *>(pixels.data()), pixels.size());
+}
+
+uint32_t crc32(uint8_t const *data, size_t size, uint32_t crc = 0)
+{
+    static std::array<uint32_t, 256> const table = []() {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t n = 0; n < t.size(); ++n)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+void put_u32(std::vector<uint8_t> &out, uint32_t value)
+{
+    out.insert(out.end(), {static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16),
+                           static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)});
+}
+
+void put_chunk(std::ofstream &ofs, char const (&type)[5], std::vector<uint8_t> const &data)
+{
+    std::vector<uint8_t> chunk;
+    put_u32(chunk, static_cast<uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    put_u32(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    ofs.write(reinterpret_cast<char const *>(chunk.data()), chunk.size());
+}
+
+// https://www.w3.org/TR/png/
+// Image data is zlib stream of stored deflate blocks, so no compression library is needed
+void write_png(std::ofstream &ofs, frame_view frame)
+{
+    static constexpr uint8_t SIGNATURE[]{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    ofs.write(reinterpret_cast<char const *>(SIGNATURE), sizeof(SIGNATURE));
+
+    std::vector<uint8_t> header;
+    put_u32(header, SCREEN_WIDTH);
+    put_u32(header, SCREEN_HEIGHT);
+    header.insert(header.end(), {8, 2, 0, 0, 0}); // 8 bit RGB, no interlace
+    put_chunk(ofs, "IHDR", header);
+
+    // every row starts with filter type 0
+    auto const raw = rgb_rows(frame, 1);
+
+    std::vector<uint8_t> zlib{0x78, 0x01};
+    constexpr size_t MAX_BLOCK{0xFFFF};
+    for (size_t pos = 0; pos < raw.size(); pos += MAX_BLOCK)
+    {
+        size_t const size = std::min(MAX_BLOCK, raw.size() - pos);
+        bool const last = pos + size == raw.size();
+        zlib.insert(zlib.end(), {static_cast<uint8_t>(last), static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8),
+                                 static_cast<uint8_t>(~size), static_cast<uint8_t>(~size >> 8)});
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + size);
+    }
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw)
+    {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    put_u32(zlib, b << 16 | a);
+
+    put_chunk(ofs, "IDAT", zlib);
+    put_chunk(ofs, "IEND", {});
+}
+
+} // namespace
+
+void write_image(std::filesystem::path const &file, frame_view frame, image_format format)
+{
+    std::ofstream ofs{file, std::ios_base::out | std::ios_base::binary};
+    if (!ofs.is_open())
+        throw std::runtime_error("Cannot open file: " + file.string() + "\n");
+
+    if (format == image_format::PNG)
+        write_png(ofs, frame);
+    else
+        write_ppm(ofs, frame);
+
+    if (!ofs)
+        throw std::runtime_error("Cannot write file: " + file.string() + "\n");
+}
@@ -0,0 +1,43 @@
+#include <software_screen.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+software_screen::software_screen(std::filesystem::path dump_directory, image_format format)
+    : m_dump_directory{std::move(dump_directory)}, m_format{format}
+{
+    std::for_each(m_buffers.begin(), m_buffers.end(), [](auto &b) { b.fill(make_color(255, 255, 255)); });
+    if (!m_dump_directory.empty())
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(m_dump_directory, ec);
+        if (ec)
+            throw std::runtime_error("Cannot create directory: " + m_dump_directory.string() + "\n");
+    }
+}
+
+void software_screen::after_frame(frame_view frame)
+{
+    size_t const back = m_front ^ 1;
+    std::copy(frame.begin(), frame.end(), m_buffers[back].begin());
+    m_front = back;
+
+    if (!m_dump_directory.empty())
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%06llu.%s", static_cast<unsigned long long>(m_frames),
+                      m_format == image_format::PNG ? "png" : "ppm");
+        write_image(m_dump_directory / name, last_frame(), m_format);
+    }
+    ++m_frames;
+}
+
+frame_view software_screen::last_frame() const
+{
+    return frame_view{m_buffers[m_front]};
+}
+
+uint64_t software_screen::frames() const
+{
+    return m_frames;
+}
@@ -0,0 +1,260 @@
+#include "video_encoder.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+// 4194304 Hz / 70224 dots per frame
+constexpr uint64_t FRAME_RATE_NUMERATOR{4194304};
+constexpr uint64_t FRAME_RATE_DENOMINATOR{70224};
+
+// https://wiki.multimedia.cx/index.php/YUV4MPEG2
+// Full resolution planes Y, Cb, Cr, BT.601 studio range
+class y4m_encoder : public video_encoder
+{
+  public:
+    explicit y4m_encoder(std::ostream &out) : m_out{out}
+    {
+        m_out << "YUV4MPEG2 W" << SCREEN_WIDTH << " H" << SCREEN_HEIGHT << " F" << FRAME_RATE_NUMERATOR << ':'
+              << FRAME_RATE_DENOMINATOR << " Ip A1:1 C444\n";
+    }
+
+    void write_frame(frame_view frame) override
+    {
+        size_t const plane = frame.size();
+        for (size_t i = 0; i < plane; ++i)
+        {
+            int const r = color_red(frame[i]);
+            int const g = color_green(frame[i]);
+            int const b = color_blue(frame[i]);
+            m_planes[i] = static_cast<uint8_t>(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+            m_planes[plane + i] = static_cast<uint8_t>(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+            m_planes[plane * 2 + i] = static_cast<uint8_t>(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+        }
+        m_out << "FRAME\n";
+        m_out.write(reinterpret_cast<char const *>(m_planes.data()), m_planes.size());
+    }
+
+  private:
+    std::ostream &m_out;
+    std::array<uint8_t, SCREEN_WIDTH * SCREEN_HEIGHT * 3> m_planes{};
+};
+
+// https://www.w3.org/Graphics/GIF/spec-gif89a.txt
+// Every pixel is index of its shade, so the color table has four entries and LZW starts with 2 bit symbols
+// Delays are whole centiseconds and players slow down shorter ones, so every second frame is kept,
+// the same image shown longer becomes one frame with longer delay
+class gif_encoder : public video_encoder
+{
+  public:
+    explicit gif_encoder(std::ostream &out) : m_out{out}
+    {
+        m_out.write("GIF89a", 6);
+        put_u16(SCREEN_WIDTH);
+        put_u16(SCREEN_HEIGHT);
+        // global table of 2^(1 + 1) colors, 8 bits per primary
+        put_bytes({0xF1, 0x00, 0x00});
+        for (color const c : SCREEN_SHADES)
+            put_bytes({color_red(c), color_green(c), color_blue(c)});
+
+        // loops forever
+        put_bytes({0x21, 0xFF, 0x0B});
+        m_out.write("NETSCAPE2.0", 11);
+        put_bytes({0x03, 0x01, 0x00, 0x00, 0x00});
+    }
+
+    void write_frame(frame_view frame) override
+    {
+        uint64_t const number = m_frames++;
+        if (number % FRAME_STEP != 0)
+            return;
+
+        // still screen is found without mapping its colors
+        if (m_has_pending && std::equal(frame.begin(), frame.end(), m_last_frame.begin()))
+            return;
+        std::copy(frame.begin(), frame.end(), m_last_frame.begin());
+
+        std::transform(frame.begin(), frame.end(), m_indexes.begin(), shade_index);
+        if (m_has_pending && m_indexes == m_pending)
+            return;
+
+        write_pending(number);
+        m_pending.swap(m_indexes);
+        m_pending_first = number;
+        m_has_pending = true;
+    }
+
+    void finish() override
+    {
+        write_pending(std::max(m_frames, m_pending_first + FRAME_STEP));
+        m_out.put(0x3B);
+    }
+
+  private:
+    static constexpr uint64_t FRAME_STEP{2};
+    static constexpr uint8_t MIN_CODE_SIZE{2};
+    static constexpr uint16_t CLEAR_CODE{1 << MIN_CODE_SIZE};
+    static constexpr uint16_t END_CODE{CLEAR_CODE + 1};
+    static constexpr uint16_t MAX_CODES{4096};
+    static constexpr uint64_t MAX_DELAY{0xFFFF};
+
+    using image = std::array<uint8_t, SCREEN_WIDTH * SCREEN_HEIGHT>;
+
+    std::ostream &m_out;
+    uint64_t m_frames{};
+
+    // image waits until it is known how long it is shown
+    image m_pending{};
+    image m_indexes{};
+    std::array<color, SCREEN_WIDTH * SCREEN_HEIGHT> m_last_frame{};
+    uint64_t m_pending_first{};
+    bool m_has_pending{};
+
+    // code of string followed by symbol is at [code * 4 + symbol], 0 when there is none
+    std::vector<uint16_t> m_table = std::vector<uint16_t>(MAX_CODES * 4);
+    std::vector<uint8_t> m_data;
+    uint32_t m_bits{};
+    int m_bit_count{};
+
+    static uint8_t shade_index(color c)
+    {
+        auto const distance = [c](color shade) {
+            return std::abs(color_red(c) - color_red(shade)) + std::abs(color_green(c) - color_green(shade)) +
+                   std::abs(color_blue(c) - color_blue(shade));
+        };
+        uint8_t nearest = 0;
+        for (uint8_t i = 0; i < SCREEN_SHADES.size(); ++i)
+        {
+            if (SCREEN_SHADES[i] == c)
+                return i;
+            if (distance(SCREEN_SHADES[i]) < distance(SCREEN_SHADES[nearest]))
+                nearest = i;
+        }
+        return nearest;
+    }
+
+    // centiseconds from the first frame to the start of frame
+    static uint64_t centiseconds(uint64_t frame)
+    {
+        return (frame * 100 * FRAME_RATE_DENOMINATOR + FRAME_RATE_NUMERATOR / 2) / FRAME_RATE_NUMERATOR;
+    }
+
+    void put_bytes(std::initializer_list<uint8_t> bytes)
+    {
+        for (uint8_t const b : bytes)
+            m_out.put(static_cast<char>(b));
+    }
+
+    void put_u16(size_t value)
+    {
+        put_bytes({static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)});
+    }
+
+    // Delay field has 16 bits, image shown longer is written again for the rest of the time
+    void write_pending(uint64_t end_frame)
+    {
+        if (!m_has_pending)
+            return;
+
+        compress(m_pending);
+        uint64_t delay = centiseconds(end_frame) - centiseconds(m_pending_first);
+        do
+        {
+            uint16_t const part = static_cast<uint16_t>(std::min<uint64_t>(delay, MAX_DELAY));
+            write_image(part);
+            delay -= part;
+        } while (delay > 0);
+    }
+
+    void write_image(uint16_t delay)
+    {
+        // graphic control: no disposal, no transparency
+        put_bytes({0x21, 0xF9, 0x04, 0x00});
+        put_u16(delay);
+        put_bytes({0x00, 0x00});
+
+        // image descriptor over the whole screen, no local table
+        put_bytes({0x2C});
+        put_u16(0);
+        put_u16(0);
+        put_u16(SCREEN_WIDTH);
+        put_u16(SCREEN_HEIGHT);
+        put_bytes({0x00, MIN_CODE_SIZE});
+
+        for (size_t i = 0; i < m_data.size(); i += 255)
+        {
+            size_t const size = std::min<size_t>(255, m_data.size() - i);
+            m_out.put(static_cast<char>(size));
+            m_out.write(reinterpret_cast<char const *>(m_data.data() + i), size);
+        }
+        m_out.put(0x00);
+    }
+
+    void put_code(uint16_t code, int size)
+    {
+        m_bits |= static_cast<uint32_t>(code) << m_bit_count;
+        for (m_bit_count += size; m_bit_count >= 8; m_bit_count -= 8)
+        {
+            m_data.push_back(static_cast<uint8_t>(m_bits));
+            m_bits >>= 8;
+        }
+    }
+
+    // Codes are packed from the lowest bit, code size grows when decoder's table reaches it
+    // Full table is cleared and built again
+    void compress(image const &indexes)
+    {
+        m_data.clear();
+        m_bits = 0;
+        m_bit_count = 0;
+
+        int size = MIN_CODE_SIZE + 1;
+        uint16_t next_code = END_CODE + 1;
+        std::fill(m_table.begin(), m_table.end(), 0);
+        put_code(CLEAR_CODE, size);
+
+        uint16_t prefix = indexes[0];
+        for (size_t i = 1; i < indexes.size(); ++i)
+        {
+            uint8_t const symbol = indexes[i];
+            if (uint16_t const code = m_table[prefix * 4 + symbol]; code != 0)
+            {
+                prefix = code;
+                continue;
+            }
+
+            put_code(prefix, size);
+            m_table[prefix * 4 + symbol] = next_code++;
+            if (next_code > (1 << size) && size < 12)
+                ++size;
+            if (next_code == MAX_CODES)
+            {
+                put_code(CLEAR_CODE, size);
+                size = MIN_CODE_SIZE + 1;
+                next_code = END_CODE + 1;
+                std::fill(m_table.begin(), m_table.end(), 0);
+            }
+            prefix = symbol;
+        }
+        put_code(prefix, size);
+        // decoder adds an entry for the last code too
+        if (next_code + 1 > (1 << size) && size < 12)
+            ++size;
+        put_code(END_CODE, size);
+        if (m_bit_count > 0)
+            m_data.push_back(static_cast<uint8_t>(m_bits));
+    }
+};
+
+} // namespace
+
+std::unique_ptr<video_encoder> make_video_encoder(std::ostream &out, video_format format)
+{
+    if (format == video_format::GIF)
+        return std::make_unique<gif_encoder>(out);
+    return std::make_unique<y4m_encoder>(out);
+}
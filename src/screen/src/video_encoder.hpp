@@ -0,0 +1,25 @@
+#ifndef VIDEO_ENCODER_HPP
+#define VIDEO_ENCODER_HPP
+
+#include <common.hpp>
+#include <video_recorder.hpp>
+#include <memory>
+#include <ostream>
+
+// Writes header when created, then frames one by one
+class video_encoder
+{
+  public:
+    virtual ~video_encoder() = default;
+
+    virtual void write_frame(frame_view frame) = 0;
+
+    // Writes what the format needs after the last frame
+    virtual void finish()
+    {
+    }
+};
+
+std::unique_ptr<video_encoder> make_video_encoder(std::ostream &out, video_format format);
+
+#endif
@@ -0,0 +1,89 @@
+#include "video_encoder.hpp"
+#include <video_recorder.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+video_recorder::video_recorder(std::filesystem::path const &file, video_format format)
+    : m_path{file}, m_file{file, std::ios_base::out | std::ios_base::binary},
+      m_ring{std::make_unique<spsc_queue<job, RING_FRAMES>>()}
+{
+    if (!m_file.is_open())
+        throw std::runtime_error("Cannot open file: " + file.string() + "\n");
+    m_encoder = make_video_encoder(m_file, format);
+    m_thread = std::thread{&video_recorder::work, this};
+}
+
+video_recorder::~video_recorder()
+{
+    try
+    {
+        finish();
+    }
+    catch (std::exception const &)
+    {
+        // error is reported only by explicit finish
+    }
+}
+
+// Never waits, frame is copied once straight into its slot, the encoder is woken once per frame
+void video_recorder::after_frame(frame_view frame)
+{
+    job *const slot = m_finished ? nullptr : m_ring->try_claim();
+    if (!slot)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::copy(frame.begin(), frame.end(), slot->m_frame.begin());
+    slot->m_last = false;
+    m_ring->commit();
+    m_ring->wake_consumer();
+}
+
+void video_recorder::finish()
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+
+    // the only place which waits, for the frames still in the ring
+    m_ring->claim().m_last = true;
+    m_ring->commit();
+    m_ring->wake_consumer();
+    m_thread.join();
+
+    if (!m_failed)
+        m_encoder->finish();
+    m_file.close();
+    if (m_failed || m_file.fail())
+        throw std::runtime_error("Cannot write file: " + m_path.string() + "\n");
+}
+
+uint64_t video_recorder::recorded_frames() const
+{
+    return m_recorded.load(std::memory_order_relaxed);
+}
+
+uint64_t video_recorder::dropped_frames() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+// Frames are encoded in place in the ring
+// After write error frames are only taken out of the ring and counted as dropped
+void video_recorder::work()
+{
+    for (job *j = &m_ring->front(); !j->m_last; m_ring->release(), j = &m_ring->front())
+    {
+        if (!m_failed.load(std::memory_order_relaxed))
+        {
+            m_encoder->write_frame(frame_view{j->m_frame});
+            if (m_file.good())
+                m_recorded.fetch_add(1, std::memory_order_relaxed);
+            else
+                m_failed.store(true, std::memory_order_relaxed);
+        }
+        if (m_failed.load(std::memory_order_relaxed))
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
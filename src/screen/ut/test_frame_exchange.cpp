@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <frame_exchange.hpp>
+#include "test_helpers.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(frame_exchange_tests, newest_frame_is_taken_once)
+{
+    frame_exchange exchange;
+    ASSERT_FALSE(exchange.take_frame());
+
+    for (uint8_t i = 1; i <= 3; ++i)
+    {
+        auto const frame = filled_frame(make_color(i, 0, 0));
+        exchange.after_frame(frame_view{frame.data(), frame.size()});
+    }
+    auto const taken = exchange.take_frame();
+    ASSERT_TRUE(taken);
+    ASSERT_EQ((*taken)[0], make_color(3, 0, 0));
+    ASSERT_FALSE(exchange.take_frame());
+
+    // taken frame stays while emulation goes on
+    auto const next = filled_frame(make_color(4, 0, 0));
+    exchange.after_frame(frame_view{next.data(), next.size()});
+    exchange.after_frame(frame_view{next.data(), next.size()});
+    ASSERT_EQ((*taken)[SCREEN_WIDTH * SCREEN_HEIGHT - 1], make_color(3, 0, 0));
+    ASSERT_EQ(exchange.wait_frame()[0], make_color(4, 0, 0));
+}
+
+TEST(frame_exchange_tests, presenter_sees_only_whole_frames_in_order)
+{
+    frame_exchange exchange;
+    constexpr uint32_t FRAMES{2000};
+    std::atomic<bool> done{};
+
+    std::thread emulation{[&exchange, &done]() {
+        for (uint32_t i = 1; i <= FRAMES; ++i)
+        {
+            auto const frame = filled_frame(i);
+            exchange.after_frame(frame_view{frame.data(), frame.size()});
+        }
+        done = true;
+    }};
+
+    color last{};
+    for (bool finished = false; !finished;)
+    {
+        finished = done;
+        auto const frame = exchange.take_frame();
+        if (!frame)
+            continue;
+        ASSERT_GT((*frame)[0], last);
+        ASSERT_EQ(std::count(frame->begin(), frame->end(), (*frame)[0]), frame->size());
+        last = (*frame)[0];
+    }
+    emulation.join();
+    ASSERT_EQ(last, FRAMES);
+}
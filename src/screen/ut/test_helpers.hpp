@@ -0,0 +1,22 @@
+#ifndef TEST_HELPERS_HPP
+#define TEST_HELPERS_HPP
+
+#include <common.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+inline std::vector<uint8_t> read_all(std::filesystem::path const &file)
+{
+    std::ifstream ifs{file, std::ios_base::in | std::ios_base::binary};
+    return {std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+}
+
+inline std::vector<color> filled_frame(color c)
+{
+    return std::vector<color>(SCREEN_WIDTH * SCREEN_HEIGHT, c);
+}
+
+#endif
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <software_screen.hpp>
+#include "test_helpers.hpp"
+
+#include <zlib.h>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// PNG stores numbers big endian
+uint32_t read_u32(uint8_t const *data)
+{
+    return static_cast<uint32_t>(data[0]) << 24 | static_cast<uint32_t>(data[1]) << 16 |
+           static_cast<uint32_t>(data[2]) << 8 | data[3];
+}
+
+} // namespace
+
+TEST(software_screen_tests, keeps_last_completed_frame)
+{
+    software_screen screen;
+    ASSERT_EQ(screen.frames(), 0u);
+    ASSERT_EQ(screen.last_frame()[0], make_color(255, 255, 255));
+
+    auto const red = filled_frame(make_color(255, 0, 0));
+    auto const blue = filled_frame(make_color(0, 0, 255));
+    screen.after_frame(frame_view{red.data(), red.size()});
+    frame_view const first = screen.last_frame();
+    screen.after_frame(frame_view{blue.data(), blue.size()});
+
+    ASSERT_EQ(screen.frames(), 2u);
+    ASSERT_EQ(screen.last_frame()[100], make_color(0, 0, 255));
+    // front and back buffers are swapped, not overwritten
+    ASSERT_EQ(first[100], make_color(255, 0, 0));
+}
+
+TEST(software_screen_tests, frames_are_dumped_as_ppm)
+{
+    auto const dir = std::filesystem::temp_directory_path() / "software_screen_ppm";
+    std::filesystem::remove_all(dir);
+
+    software_screen screen{dir};
+    auto frame = filled_frame(make_color(1, 2, 3));
+    frame.back() = make_color(4, 5, 6);
+    screen.after_frame(frame_view{frame.data(), frame.size()});
+    screen.after_frame(frame_view{frame.data(), frame.size()});
+
+    auto const data = read_all(dir / "frame_000001.ppm");
+    std::string const header{"P6\n160 144\n255\n"};
+    ASSERT_EQ(data.size(), header.size() + SCREEN_WIDTH * SCREEN_HEIGHT * 3);
+    ASSERT_TRUE(std::equal(header.begin(), header.end(), data.begin()));
+    ASSERT_EQ(data[header.size()], 1);
+    ASSERT_EQ(data[header.size() + 2], 3);
+    ASSERT_EQ(data.back(), 6);
+}
+
+TEST(software_screen_tests, frames_are_dumped_as_png)
+{
+    auto const dir = std::filesystem::temp_directory_path() / "software_screen_png";
+    std::filesystem::remove_all(dir);
+
+    software_screen screen{dir, image_format::PNG};
+    auto frame = filled_frame(make_color(1, 2, 3));
+    for (size_t i = 0; i < frame.size(); i += 7)
+        frame[i] = make_color(static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 200);
+    screen.after_frame(frame_view{frame.data(), frame.size()});
+
+    auto const data = read_all(dir / "frame_000000.png");
+    std::vector<uint8_t> const signature{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    ASSERT_GE(data.size(), signature.size());
+    ASSERT_TRUE(std::equal(signature.begin(), signature.end(), data.begin()));
+
+    // length, type, data, CRC of type and data
+    std::vector<std::string> types;
+    std::vector<uint8_t> header;
+    std::vector<uint8_t> image;
+    for (size_t pos = signature.size(); pos < data.size();)
+    {
+        ASSERT_LE(pos + 12, data.size());
+        uint32_t const length = read_u32(data.data() + pos);
+        ASSERT_LE(pos + 12 + length, data.size());
+        uint8_t const *const type = data.data() + pos + 4;
+        uint8_t const *const chunk = type + 4;
+        ASSERT_EQ(read_u32(chunk + length), crc32(0, type, length + 4));
+
+        types.emplace_back(type, type + 4);
+        if (types.back() == "IHDR")
+            header.assign(chunk, chunk + length);
+        else if (types.back() == "IDAT")
+            image.insert(image.end(), chunk, chunk + length);
+        pos += 12 + length;
+    }
+    ASSERT_EQ(types, (std::vector<std::string>{"IHDR", "IDAT", "IEND"}));
+
+    // 8 bit RGB, no interlace
+    ASSERT_EQ(header.size(), 13u);
+    ASSERT_EQ(read_u32(header.data()), SCREEN_WIDTH);
+    ASSERT_EQ(read_u32(header.data() + 4), SCREEN_HEIGHT);
+    ASSERT_EQ(std::vector<uint8_t>(header.begin() + 8, header.end()), (std::vector<uint8_t>{8, 2, 0, 0, 0}));
+
+    // every row is filter type 0 and RGB of each pixel
+    size_t const row = 1 + SCREEN_WIDTH * 3;
+    std::vector<uint8_t> raw(SCREEN_HEIGHT * row + 1);
+    uLongf raw_size = static_cast<uLongf>(raw.size());
+    ASSERT_EQ(uncompress(raw.data(), &raw_size, image.data(), static_cast<uLong>(image.size())), Z_OK);
+    ASSERT_EQ(raw_size, SCREEN_HEIGHT * row);
+    for (size_t y = 0; y < SCREEN_HEIGHT; ++y)
+    {
+        ASSERT_EQ(raw[y * row], 0);
+        for (size_t x = 0; x < SCREEN_WIDTH; ++x)
+        {
+            color const c = frame[y * SCREEN_WIDTH + x];
+            uint8_t const *const pixel = raw.data() + y * row + 1 + x * 3;
+            ASSERT_EQ(make_color(pixel[0], pixel[1], pixel[2]), c) << x << ", " << y;
+        }
+    }
+}
@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include "../src/video_encoder.hpp"
+#include <video_recorder.hpp>
+#include "test_helpers.hpp"
+
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+constexpr size_t PIXELS{SCREEN_WIDTH * SCREEN_HEIGHT};
+
+// frame of random shades, returns their indexes too
+std::vector<color> random_frame(std::mt19937 &rng, std::vector<uint8_t> &indexes)
+{
+    std::vector<color> frame(PIXELS);
+    indexes.resize(PIXELS);
+    for (size_t i = 0; i < PIXELS; ++i)
+    {
+        // long runs are made of the same shade, so the LZW table also gets long strings
+        indexes[i] = (i % 1000 < 500) ? static_cast<uint8_t>(rng() % 4) : indexes[i % 500];
+        frame[i] = SCREEN_SHADES[indexes[i]];
+    }
+    return frame;
+}
+
+struct gif_image
+{
+    uint16_t m_delay{};
+    std::vector<uint8_t> m_indexes;
+};
+
+std::vector<uint8_t> lzw_decode(std::vector<uint8_t> const &data, int min_size)
+{
+    uint16_t const clear = 1 << min_size;
+    uint16_t const end = clear + 1;
+    std::vector<std::vector<uint8_t>> table(4096);
+    for (uint16_t i = 0; i < clear; ++i)
+        table[i] = {static_cast<uint8_t>(i)};
+
+    std::vector<uint8_t> out;
+    int size = min_size + 1;
+    uint16_t next = end + 1;
+    int prev = -1;
+    size_t bit = 0;
+    while (bit + size <= data.size() * 8)
+    {
+        uint16_t code = 0;
+        for (int i = 0; i < size; ++i, ++bit)
+            code |= ((data[bit / 8] >> (bit % 8)) & 1) << i;
+
+        if (code == clear)
+        {
+            size = min_size + 1;
+            next = end + 1;
+            prev = -1;
+            continue;
+        }
+        if (code == end)
+            return out;
+
+        std::vector<uint8_t> entry;
+        if (code < next && code != clear && code != end)
+            entry = table[code];
+        else if (code == next && prev >= 0)
+        {
+            entry = table[prev];
+            entry.push_back(table[prev][0]);
+        }
+        else
+            throw std::runtime_error("invalid code\n");
+
+        out.insert(out.end(), entry.begin(), entry.end());
+        if (prev >= 0 && next < 4096)
+        {
+            table[next] = table[prev];
+            table[next].push_back(entry[0]);
+            if (++next == (1 << size) && size < 12)
+                ++size;
+        }
+        prev = code;
+    }
+    throw std::runtime_error("no end code\n");
+}
+
+// Images with their delays, checks structure on the way
+std::vector<gif_image> decode_gif(std::vector<uint8_t> const &file)
+{
+    EXPECT_EQ(std::string(file.begin(), file.begin() + 6), "GIF89a");
+    EXPECT_EQ(file[6] | file[7] << 8, 160);
+    EXPECT_EQ(file[8] | file[9] << 8, 144);
+    EXPECT_EQ(file[10], 0xF1);
+    for (size_t i = 0; i < SCREEN_SHADES.size(); ++i)
+        EXPECT_EQ(file[13 + i * 3], color_red(SCREEN_SHADES[i]));
+
+    auto const sub_blocks = [&file](size_t &pos) {
+        std::vector<uint8_t> data;
+        for (uint8_t size = file.at(pos++); size != 0; size = file.at(pos++))
+        {
+            data.insert(data.end(), file.begin() + pos, file.begin() + pos + size);
+            pos += size;
+        }
+        return data;
+    };
+
+    std::vector<gif_image> images;
+    uint16_t delay = 0;
+    for (size_t pos = 13 + 4 * 3;;)
+    {
+        uint8_t const block = file.at(pos++);
+        if (block == 0x3B)
+        {
+            EXPECT_EQ(pos, file.size());
+            return images;
+        }
+        if (block == 0x21)
+        {
+            uint8_t const label = file.at(pos++);
+            auto const data = sub_blocks(pos);
+            if (label == 0xF9)
+                delay = data[1] | data[2] << 8;
+        }
+        else if (block == 0x2C)
+        {
+            pos += 9;
+            int const min_size = file.at(pos++);
+            images.push_back({delay, lzw_decode(sub_blocks(pos), min_size)});
+        }
+        else
+            throw std::runtime_error("unknown block\n");
+    }
+}
+
+} // namespace
+
+TEST(video_recorder_tests, y4m_has_header_and_every_frame)
+{
+    auto const file = std::filesystem::temp_directory_path() / "video_recorder.y4m";
+    std::vector<color> frame(PIXELS, SCREEN_SHADES[0]);
+    frame.back() = SCREEN_SHADES[3];
+    {
+        video_recorder recorder{file, video_format::Y4M};
+        for (int i = 0; i < 5; ++i)
+            recorder.after_frame(frame_view{frame.data(), frame.size()});
+        recorder.finish();
+        ASSERT_EQ(recorder.recorded_frames() + recorder.dropped_frames(), 5u);
+        ASSERT_EQ(recorder.recorded_frames(), 5u);
+    }
+
+    auto const data = read_all(file);
+    std::string const header{"YUV4MPEG2 W160 H144 F4194304:70224 Ip A1:1 C444\n"};
+    ASSERT_EQ(data.size(), header.size() + 5 * (6 + PIXELS * 3));
+    ASSERT_TRUE(std::equal(header.begin(), header.end(), data.begin()));
+
+    size_t const last_frame = data.size() - PIXELS * 3;
+    ASSERT_EQ(std::string(data.begin() + last_frame - 6, data.begin() + last_frame), "FRAME\n");
+    // white and black in studio range, no color
+    ASSERT_EQ(data[last_frame], 235);
+    ASSERT_EQ(data[last_frame + PIXELS - 1], 16);
+    ASSERT_EQ(data[last_frame + PIXELS], 128);
+    ASSERT_EQ(data.back(), 128);
+}
+
+TEST(video_recorder_tests, gif_decodes_to_shades_of_kept_frames)
+{
+    auto const file = std::filesystem::temp_directory_path() / "video_recorder.gif";
+    std::mt19937 rng{7};
+    std::vector<std::vector<uint8_t>> indexes(6);
+    {
+        video_recorder recorder{file, video_format::GIF};
+        for (auto &i : indexes)
+        {
+            auto const frame = random_frame(rng, i);
+            recorder.after_frame(frame_view{frame.data(), frame.size()});
+        }
+    }
+
+    // every second frame, 3 or 4 centiseconds each
+    auto const images = decode_gif(read_all(file));
+    ASSERT_EQ(images.size(), 3u);
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        ASSERT_EQ(images[i].m_indexes, indexes[i * 2]) << "image " << i;
+        ASSERT_GE(images[i].m_delay, 3);
+        ASSERT_LE(images[i].m_delay, 4);
+    }
+}
+
+TEST(video_recorder_tests, gif_shows_unchanged_image_longer)
+{
+    auto const file = std::filesystem::temp_directory_path() / "video_recorder_still.gif";
+    std::vector<color> frame(PIXELS, SCREEN_SHADES[1]);
+    {
+        video_recorder recorder{file, video_format::GIF};
+        for (int i = 0; i < 60; ++i)
+            recorder.after_frame(frame_view{frame.data(), frame.size()});
+        frame[0] = SCREEN_SHADES[2];
+        for (int i = 0; i < 2; ++i)
+            recorder.after_frame(frame_view{frame.data(), frame.size()});
+    }
+
+    auto const images = decode_gif(read_all(file));
+    ASSERT_EQ(images.size(), 2u);
+    // 60 frames last a bit more than a second
+    ASSERT_EQ(images[0].m_delay, 100);
+    ASSERT_EQ(images[1].m_indexes[0], 2);
+    ASSERT_EQ(images[1].m_indexes[1], 1);
+}
+
+TEST(video_recorder_tests, full_ring_drops_frames)
+{
+    auto const file = std::filesystem::temp_directory_path() / "video_recorder_drop.y4m";
+    std::vector<color> frame(PIXELS, SCREEN_SHADES[2]);
+    uint64_t recorded{};
+    {
+        video_recorder recorder{file, video_format::Y4M};
+        for (int i = 0; i < 200; ++i)
+            recorder.after_frame(frame_view{frame.data(), frame.size()});
+        recorder.finish();
+        recorded = recorder.recorded_frames();
+        ASSERT_EQ(recorded + recorder.dropped_frames(), 200u);
+
+        // nothing is taken after finish
+        recorder.after_frame(frame_view{frame.data(), frame.size()});
+        ASSERT_EQ(recorder.recorded_frames() + recorder.dropped_frames(), 201u);
+    }
+
+    auto const data = read_all(file);
+    std::string const header{"YUV4MPEG2 W160 H144 F4194304:70224 Ip A1:1 C444\n"};
+    ASSERT_EQ(data.size(), header.size() + recorded * (6 + PIXELS * 3));
+}
+
+TEST(video_recorder_tests, gif_splits_delay_longer_than_its_field)
+{
+    // over 655.35 s of one image, encoder is used directly, so no frame is dropped
+    std::ostringstream out;
+    auto encoder = make_video_encoder(out, video_format::GIF);
+    std::vector<color> const frame(PIXELS, SCREEN_SHADES[3]);
+    constexpr uint64_t FRAMES{40000};
+    for (uint64_t i = 0; i < FRAMES; ++i)
+        encoder->write_frame(frame_view{frame.data(), frame.size()});
+    encoder->finish();
+
+    std::string const data{out.str()};
+    auto const images = decode_gif(std::vector<uint8_t>(data.begin(), data.end()));
+    ASSERT_EQ(images.size(), 2u);
+    ASSERT_EQ(images[0].m_delay, 0xFFFF);
+    // 40000 frames of 70224 dots at 4194304 Hz
+    ASSERT_EQ(images[0].m_delay + images[1].m_delay, 66971);
+    ASSERT_EQ(images[1].m_indexes, images[0].m_indexes);
+}